@@ -0,0 +1,45 @@
+#include "bench.hpp"
+
+#include <json/batch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+/// Parses a batch of ten thousand small files with one worker thread up to one per hardware thread
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "json_batch_bench";
+    std::filesystem::create_directories(directory);
+    std::vector<std::filesystem::path> paths;
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < 10000; i++) {
+        const std::string json = make_manifest_document(10 + i % 40);
+        paths.emplace_back(directory / ("file" + std::to_string(i) + ".json"));
+        std::ofstream(paths.back()) << json;
+        total_bytes += json.length();
+    }
+
+    int status = 0;
+    const size_t max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    double single_ms = 0;
+    std::printf("%zu files, %.1f MB\n", paths.size(), static_cast<double>(total_bytes) / 1e6);
+    std::printf("%8s %10s %10s %9s\n", "threads", "ms", "MB/s", "speedup");
+    // Powers of two below the hardware thread count, then the hardware thread count itself
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.emplace_back(threads);
+    }
+    thread_counts.emplace_back(max_threads);
+    for (const size_t threads : thread_counts) {
+        const double ms = best_of(3, [&] {
+            for (const JsonFileResult &result : JsonBatchParser::parse_files(paths, threads)) {
+                status |= result.ok() ? 0 : 1;
+            }
+        });
+        single_ms = threads == 1 ? ms : single_ms;
+        std::printf("%8zu %10.2f %10.1f %8.2fx\n", threads, ms, mb_per_s(total_bytes, ms), single_ms / ms);
+    }
+    std::filesystem::remove_all(directory);
+    return status;
+}
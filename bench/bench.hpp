@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+/// @function `best_of`
+/// @brief Runs the given function a number of times and returns the duration of the fastest run
+///
+/// @param `runs` How often to run the function
+/// @param `fn` The function to measure
+/// @return `double` The duration of the fastest run in milliseconds
+template <typename Fn> double best_of(const int runs, Fn &&fn) {
+    double best = 0;
+    for (int i = 0; i < runs; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/// @function `mb_per_s`
+/// @brief Returns the throughput of processing the given number of bytes in the given time
+///
+/// @param `bytes` The number of bytes processed
+/// @param `ms` The time it took in milliseconds
+/// @return `double` The throughput in MB/s
+inline double mb_per_s(const size_t bytes, const double ms) {
+    return static_cast<double>(bytes) / 1e6 / (ms / 1e3);
+}
+
+/// @function `keep`
+/// @brief Keeps the compiler from optimizing away the computation of the given value
+template <typename T> void keep(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/// @function `make_long_strings_document`
+/// @brief Generates a document of string fields with long values, like embedded sources or base64 blobs
+///
+/// @param `fields` The number of fields
+/// @param `value_length` The length of every string value
+/// @return `std::string` The document
+inline std::string make_long_strings_document(const size_t fields, const size_t value_length) {
+    std::string json = "{\n";
+    for (size_t i = 0; i < fields; i++) {
+        json += "\t\"blob" + std::to_string(i) + "\": \"";
+        for (size_t j = 0; j < value_length; j++) {
+            json += static_cast<char>('A' + (i + j) % 26);
+        }
+        json += i + 1 == fields ? "\"\n" : "\",\n";
+    }
+    json += "}\n";
+    return json;
+}
+
+/// @function `make_manifest_document`
+/// @brief Generates a wide document of package entries with a small nested group each, pretty printed like a manifest file
+///
+/// @param `packages` The number of package entries
+/// @return `std::string` The document
+inline std::string make_manifest_document(const size_t packages) {
+    std::string json = "{\n";
+    for (size_t i = 0; i < packages; i++) {
+        const std::string id = std::to_string(i);
+        json += "\t\"package" + id + "\": {\n";
+        json += "\t\t\"name\": \"package-" + id + "\",\n";
+        json += "\t\t\"version\": \"1." + std::to_string(i % 10) + "." + std::to_string(i % 7) + "\",\n";
+        json += "\t\t\"path\": \"/opt/packages/package-" + id + "/lib\",\n";
+        json += "\t\t\"size\": " + std::to_string(i * 37 % 100000) + ",\n";
+        json += "\t\t\"build\": {\n\t\t\t\"number\": " + std::to_string(i % 1000) + ",\n\t\t\t\"license\": \"MIT\"\n\t\t}\n";
+        json += i + 1 == packages ? "\t}\n" : "\t},\n";
+    }
+    json += "}\n";
+    return json;
+}
+
+/// @function `make_deep_document`
+/// @brief Generates a document of groups nested into each other, every group holds a number and the next group
+///
+/// @param `depth` The number of nested groups, the root group included
+/// @return `std::string` The document
+inline std::string make_deep_document(const size_t depth) {
+    std::string json;
+    for (size_t i = 1; i < depth; i++) {
+        json += "{\"a\": 1, \"g\": ";
+    }
+    json += "{\"a\": 1}";
+    json.append(depth - 1, '}');
+    return json;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global `operator new` and `operator delete` with versions which count every allocation. The replacements are not
+// inline, so this header may only be included by a single translation unit of a program
+
+/// @var `allocation_count`
+/// @brief The number of calls to the global `operator new` so far
+inline size_t allocation_count = 0;
+
+/// @var `allocated_bytes`
+/// @brief The number of bytes requested from the global `operator new` so far
+inline size_t allocated_bytes = 0;
+
+// Not inlined, so the compiler does not pair the `malloc` with the sized `operator delete` of the library
+__attribute__((noinline)) void *operator new(const size_t size) {
+    allocation_count++;
+    allocated_bytes += size;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// Not inlined, so the compiler does not pair the `free` with the `new` expression it was inlined into
+__attribute__((noinline)) void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
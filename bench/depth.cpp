@@ -0,0 +1,48 @@
+#include "bench.hpp"
+
+#include <json/error.hpp>
+#include <json/lexer.hpp>
+#include <json/parser.hpp>
+
+/// Parses documents of growing nesting depth, the time per level stays flat when parsing scales linearly with the depth. Input which
+/// is deeper than the limit is rejected without looking at the deeper content
+int main() {
+    JsonParseOptions options;
+    options.max_depth = SIZE_MAX;
+    std::printf("%10s %12s %12s %16s %16s\n", "depth", "parse ms", "buffer ms", "parse ns/level", "buffer ns/level");
+    for (const size_t depth : {1, 10, 100, 1000, 10000, 100000, 1000000}) {
+        const std::string json = make_deep_document(depth);
+        const JsonTokenList tokens = JsonLexer::scan_buffer(json);
+        const double parse_ms = best_of(5, [&] { keep(JsonParser::parse(tokens, options)); });
+        const double buffer_ms = best_of(5, [&] { keep(JsonParser::parse_buffer(json, options)); });
+        const auto ns_per_level = [depth](const double ms) { return ms * 1e6 / static_cast<double>(depth); };
+        std::printf("%10zu %12.3f %12.3f %16.1f %16.1f\n", depth, parse_ms, buffer_ms, ns_per_level(parse_ms), ns_per_level(buffer_ms));
+    }
+
+    // A million unclosed groups under the default limit, both parsers stop at the first group beyond it
+    std::string unclosed;
+    for (size_t i = 0; i < 1000000; i++) {
+        unclosed += "{\"g\": ";
+    }
+    const JsonTokenList tokens = JsonLexer::scan_buffer(unclosed);
+    std::string parse_error;
+    std::string buffer_error;
+    const double parse_ms = best_of(5, [&] {
+        JsonErrorCapture capture;
+        keep(JsonParser::parse(tokens));
+        parse_error = capture.message();
+    });
+    const double buffer_ms = best_of(5, [&] {
+        JsonErrorCapture capture;
+        keep(JsonParser::parse_buffer(unclosed));
+        buffer_error = capture.message();
+    });
+    std::printf("1000000 unclosed groups, default limit: parse %.3f ms, buffer %.3f ms\n", parse_ms, buffer_ms);
+    // Both runs have to be stopped by the depth limit, not by anything else
+    const std::string depth_error = "Error: Json nesting depth exceeds the maximum of 1024";
+    if (parse_error != depth_error || buffer_error != depth_error) {
+        std::printf("unexpected errors: '%s', '%s'\n", parse_error.c_str(), buffer_error.c_str());
+        return 1;
+    }
+    return 0;
+}
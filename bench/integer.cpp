@@ -0,0 +1,104 @@
+#include "bench.hpp"
+
+#include <json/integer.hpp>
+
+#include <charconv>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+/// Compares the integer kernels with `std::stoi` on a substring copy and `operator<<` on a stream, the previous path, and with
+/// `std::from_chars` and `std::to_chars`. The numbers have a uniformly random digit count within the given range, the first range
+/// fits into an `int`
+int main() {
+    std::mt19937_64 random(24);
+    std::printf("%-8s %-26s %10s %12s\n", "digits", "kernel", "ms", "M numbers/s");
+    for (const auto &[min_digits, max_digits] : {std::pair(1, 9), std::pair(1, 19), std::pair(19, 19)}) {
+        std::vector<uint64_t> numbers;
+        std::string text;
+        std::vector<std::pair<size_t, size_t>> ranges;
+        for (size_t i = 0; i < 1000000; i++) {
+            const int digits = min_digits + static_cast<int>(random() % static_cast<uint64_t>(max_digits - min_digits + 1));
+            uint64_t low = 1;
+            for (int j = 1; j < digits; j++) {
+                low *= 10;
+            }
+            // One-digit numbers include zero, all longer ones have exactly the chosen number of digits
+            low = digits == 1 ? 0 : low;
+            numbers.emplace_back(low + random() % ((digits == 1 ? 10 : low * 10) - low));
+            char buffer[JsonInteger::MAX_FORMATTED_LENGTH];
+            char *end = JsonInteger::format(numbers.back(), buffer);
+            ranges.emplace_back(text.length(), static_cast<size_t>(end - buffer));
+            text.append(buffer, end);
+            text += ',';
+        }
+        const std::string_view view = text;
+        const std::string label = std::to_string(min_digits) + "-" + std::to_string(max_digits);
+        const auto report = [&](const char *kernel, const double ms) {
+            std::printf("%-8s %-26s %10.2f %12.1f\n", label.c_str(), kernel, ms, static_cast<double>(numbers.size()) / 1e3 / ms);
+        };
+
+        uint64_t sum = 0;
+        if (max_digits <= 9) {
+            report("parse std::stoi", best_of(5, [&] {
+                for (const auto &[offset, length] : ranges) {
+                    sum += static_cast<uint64_t>(std::stoi(text.substr(offset, length)));
+                }
+            }));
+        } else {
+            report("parse std::stoull", best_of(5, [&] {
+                for (const auto &[offset, length] : ranges) {
+                    sum += std::stoull(text.substr(offset, length));
+                }
+            }));
+        }
+        report("parse std::from_chars", best_of(5, [&] {
+            for (const auto &[offset, length] : ranges) {
+                uint64_t value = 0;
+                std::from_chars(view.data() + offset, view.data() + offset + length, value);
+                sum += value;
+            }
+        }));
+        report("parse JsonInteger", best_of(5, [&] {
+            for (const auto &[offset, length] : ranges) {
+                uint64_t value = 0;
+                JsonInteger::parse(view.substr(offset, length), value);
+                sum += value;
+            }
+        }));
+
+        std::string output;
+        output.reserve(text.length());
+        report("format std::ostringstream", best_of(5, [&] {
+            std::ostringstream stream;
+            for (const uint64_t number : numbers) {
+                stream << number << ',';
+            }
+            output = stream.str();
+        }));
+        // Both kernels write straight into the output, which is sized up front with room for the longest number behind its end
+        const auto format_in_place = [&](auto format) {
+            output.resize(text.length() + JsonInteger::MAX_FORMATTED_LENGTH);
+            char *out = output.data();
+            for (const uint64_t number : numbers) {
+                out = format(number, out);
+                *out++ = ',';
+            }
+            output.resize(static_cast<size_t>(out - output.data()));
+        };
+        report("format std::to_chars", best_of(5, [&] {
+            format_in_place([](const uint64_t number, char *buffer) {
+                return std::to_chars(buffer, buffer + JsonInteger::MAX_FORMATTED_LENGTH, number).ptr;
+            });
+        }));
+        report("format JsonInteger", best_of(5, [&] {
+            format_in_place([](const uint64_t number, char *buffer) { return JsonInteger::format(number, buffer); });
+        }));
+        keep(sum);
+        if (output != text) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "bench.hpp"
+
+#include <json/lexer.hpp>
+
+#include <vector>
+
+/// @function `measure`
+/// @brief Prints the throughput of the scalar scan, of the block scan with every available kernel and of `scan_buffer`, which
+/// picks a kernel, reserves the token vector and builds the brace index
+///
+/// @param `label` The name of the document
+/// @param `json` The document to scan
+static void measure(const char *label, const std::string &json) {
+    std::vector<JsonToken> tokens;
+    const double scalar_ms = best_of(5, [&] {
+        tokens.clear();
+        JsonLexer::scan_scalar(json, tokens);
+    });
+#if JSON_MINI_X86_SIMD
+    const double sse2_ms = best_of(5, [&] {
+        tokens.clear();
+        JsonLexer::scan_blocks<JsonSimd::classify_sse2>(json, tokens);
+    });
+    const double avx2_ms = JsonSimd::has_avx2() ? best_of(5, [&] {
+        tokens.clear();
+        JsonLexer::scan_blocks<JsonSimd::classify_avx2>(json, tokens);
+    })
+                                                : 0;
+#else
+    const double sse2_ms = 0;
+    const double avx2_ms = 0;
+#endif
+    const double scan_ms = best_of(5, [&] { keep(JsonLexer::scan_buffer(json)); });
+    const auto throughput = [&json](const double ms) { return ms == 0 ? 0 : mb_per_s(json.length(), ms); };
+    std::printf("%-10s %8.1f %10.0f %10.0f %10.0f %12.0f\n", label, static_cast<double>(json.length()) / 1e6, throughput(scalar_ms),
+        throughput(sse2_ms), throughput(avx2_ms), throughput(scan_ms));
+}
+
+/// Compares the scalar scan with the block scan on a dense manifest and on a document of long strings
+int main() {
+    std::printf("%-10s %8s %10s %10s %10s %12s\n", "document", "MB", "scalar", "SSE2", "AVX2", "scan_buffer");
+    measure("manifest", make_manifest_document(200000));
+    measure("strings", make_long_strings_document(16 * 1024, 4096));
+    return 0;
+}
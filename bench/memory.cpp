@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include "counting_new.hpp"
+
+#include <json/flat.hpp>
+
+#include <memory>
+#include <optional>
+
+/// @function `key_bytes`
+/// @brief Returns the number of bytes the keys of the given interner occupy, one terminating byte per key included
+static size_t key_bytes(const JsonKeyInterner &interner) {
+    size_t bytes = 0;
+    for (uint32_t id = 0; id < interner.size(); id++) {
+        bytes += interner.view(id).length() + 1;
+    }
+    return bytes;
+}
+
+/// @function `copied_key_bytes`
+/// @brief Returns the number of bytes the keys of the given document would occupy if every node kept a copy of its key in the string
+/// table of the document, like before keys were interned
+static size_t copied_key_bytes(const JsonFlatDocument &document) {
+    size_t bytes = 0;
+    for (uint32_t node = 0; node < document.size(); node++) {
+        bytes += document.key(node).length() + sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+/// Reports the memory of a repetitive corpus of manifests as heap trees, as flat documents with a copy of every key per node, as
+/// flat documents with their own key table each and as flat documents sharing one key table
+int main() {
+    constexpr size_t documents = 200;
+    const std::string manifest = make_manifest_document(200);
+
+    size_t nodes = 0;
+    size_t tree_bytes = 0;
+    size_t copied_bytes = 0;
+    size_t own_bytes = 0;
+    size_t shared_bytes = 0;
+    const auto shared = std::make_shared<JsonKeyInterner>();
+    for (size_t i = 0; i < documents; i++) {
+        const size_t before = allocated_bytes;
+        const std::optional<std::unique_ptr<JsonObject>> tree = JsonParser::parse_buffer(manifest);
+        if (!tree.has_value()) {
+            return 1;
+        }
+        tree_bytes += allocated_bytes - before;
+
+        const std::optional<JsonFlatDocument> own = JsonFlatDocument::parse(manifest);
+        const std::optional<JsonFlatDocument> shared_document = JsonFlatDocument::parse(manifest, shared);
+        if (!own.has_value() || !shared_document.has_value()) {
+            return 1;
+        }
+        nodes += own.value().size();
+        copied_bytes += shared_document.value().memory_usage() + copied_key_bytes(shared_document.value());
+        own_bytes += own.value().memory_usage() + key_bytes(*own.value().key_interner());
+        shared_bytes += shared_document.value().memory_usage();
+    }
+    shared_bytes += key_bytes(*shared);
+
+    std::printf("memory of %zu manifests, %zu nodes, %zu distinct keys\n", documents, nodes, shared->size());
+    std::printf("  heap trees (bytes allocated)  %8.2f MB\n", static_cast<double>(tree_bytes) / 1e6);
+    std::printf("  flat, key copied per node     %8.2f MB\n", static_cast<double>(copied_bytes) / 1e6);
+    std::printf("  flat, own key table each      %8.2f MB\n", static_cast<double>(own_bytes) / 1e6);
+    std::printf("  flat, one shared key table    %8.2f MB  (saves %.1f%% over copied keys)\n", static_cast<double>(shared_bytes) / 1e6,
+        100.0 - 100.0 * static_cast<double>(shared_bytes) / static_cast<double>(copied_bytes));
+    return 0;
+}
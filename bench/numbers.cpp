@@ -0,0 +1,100 @@
+#include "bench.hpp"
+
+#include <json/lexer.hpp>
+#include <json/parser.hpp>
+
+#include <cstdlib>
+#include <random>
+
+/// @function `make_numbers_document`
+/// @brief Generates a telemetry-like document of number fields, mostly doubles with a fraction or an exponent, some integers
+///
+/// @param `fields` The number of fields
+/// @return `std::string` The document
+static std::string make_numbers_document(const size_t fields) {
+    std::mt19937_64 random(25);
+    std::uniform_real_distribution<double> values(-1e6, 1e6);
+    std::string json = "{\n";
+    char buffer[JsonNumberValue::MAX_FORMATTED_LENGTH];
+    for (size_t i = 0; i < fields; i++) {
+        const JsonNumberValue number = i % 4 == 0 ? JsonNumberValue(static_cast<int64_t>(random() % 1000000)) :
+            i % 4 == 1                            ? JsonNumberValue(values(random) * 1e-12)
+                                                  : JsonNumberValue(values(random));
+        json += "\t\"m" + std::to_string(i) + "\": ";
+        json.append(buffer, number.format(buffer));
+        json += i + 1 == fields ? "\n" : ",\n";
+    }
+    json += "}\n";
+    return json;
+}
+
+/// @struct `NumberSum`
+/// @brief An event handler which only adds up all numbers
+struct NumberSum {
+    double sum = 0;
+
+    bool on_object_begin() {
+        return true;
+    }
+    bool on_object_end() {
+        return true;
+    }
+    bool on_key(std::string_view) {
+        return true;
+    }
+    bool on_string(std::string_view) {
+        return true;
+    }
+    bool on_number(const JsonNumberValue &number) {
+        sum += number.to_double();
+        return true;
+    }
+};
+
+/// Compares converting the number tokens of a number-heavy document with `strtod` on a copied `std::string`, the naive path, and
+/// with `JsonNumberValue::parse`, which uses the SWAR integer kernel and `std::from_chars`. The second row adds scanning to both,
+/// the single-pass event and tree parsers are timed for reference
+int main() {
+    const std::string json = make_numbers_document(400000);
+    const JsonTokenList tokens = JsonLexer::scan_buffer(json);
+    if (tokens.empty()) {
+        return 1;
+    }
+    double sum = 0;
+    const auto strtod_tokens = [&](const JsonTokenList &list) {
+        for (const JsonToken &token : list.tokens) {
+            if (token.type == JsonTokenType::TOK_NUMBER) {
+                const std::string text(list.text(token));
+                sum += std::strtod(text.c_str(), nullptr);
+            }
+        }
+    };
+    const auto parse_tokens = [&](const JsonTokenList &list) {
+        for (const JsonToken &token : list.tokens) {
+            if (token.type == JsonTokenType::TOK_NUMBER) {
+                JsonNumberValue number;
+                JsonNumberValue::parse(list.text(token), number);
+                sum += number.to_double();
+            }
+        }
+    };
+    const double strtod_ms = best_of(7, [&] { strtod_tokens(tokens); });
+    const double parse_ms = best_of(7, [&] { parse_tokens(tokens); });
+    const double scan_strtod_ms = best_of(7, [&] { strtod_tokens(JsonLexer::scan_buffer(json)); });
+    const double scan_parse_ms = best_of(7, [&] { parse_tokens(JsonLexer::scan_buffer(json)); });
+    const double events_ms = best_of(7, [&] {
+        NumberSum handler;
+        JsonParser::parse_events(json, handler);
+        sum += handler.sum;
+    });
+    const double tree_ms = best_of(7, [&] { keep(JsonParser::parse_buffer(json)); });
+    keep(sum);
+
+    std::printf("%.1f MB, 400000 number fields\n", static_cast<double>(json.length()) / 1e6);
+    std::printf("%-24s %10s %10s %9s\n", "", "strtod ms", "fast ms", "speedup");
+    std::printf("%-24s %10.2f %10.2f %8.2fx\n", "conversion only", strtod_ms, parse_ms, strtod_ms / parse_ms);
+    std::printf("%-24s %10.2f %10.2f %8.2fx\n", "scan + conversion", scan_strtod_ms, scan_parse_ms, scan_strtod_ms / scan_parse_ms);
+    std::printf("%-24s %10s %10.2f\n", "parse_events", "", events_ms);
+    std::printf("%-24s %10s %10.2f\n", "parse_buffer", "", tree_ms);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "bench.hpp"
+
+#include <json/parser.hpp>
+
+#include <optional>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/// @function `measure`
+/// @brief Prints the throughput of writing the given tree in both formats, into memory and into a file descriptor
+///
+/// @param `label` The name of the tree
+/// @param `tree` The tree to write
+/// @param `null_fd` The file descriptor of `/dev/null`
+/// @return `bool` Whether all writes succeeded
+static bool measure(const char *label, const JsonObject *tree, const int null_fd) {
+    bool good = true;
+    for (const JsonFormat format : {JsonFormat::PRETTY, JsonFormat::COMPACT}) {
+        JsonOutputBuffer memory;
+        const double memory_ms = best_of(5, [&] {
+            memory.clear();
+            good &= JsonParser::write(tree, memory, format);
+        });
+        const size_t bytes = memory.view().length();
+        const double fd_ms = best_of(5, [&] {
+            JsonOutputBuffer output(null_fd);
+            good &= JsonParser::write(tree, output, format) && output.flush();
+        });
+        std::printf("%-6s %-8s %10.2f MB %12.1f %12.1f\n", label, format == JsonFormat::PRETTY ? "pretty" : "compact",
+            static_cast<double>(bytes) / 1e6, mb_per_s(bytes, memory_ms), mb_per_s(bytes, fd_ms));
+    }
+    return good;
+}
+
+/// Writes a deep and a wide tree in pretty and compact format, into memory and through a file descriptor. The deep tree is kept at
+/// a depth whose pretty indentation still fits into memory, it grows with the square of the depth
+int main() {
+    JsonParseOptions options;
+    options.max_depth = SIZE_MAX;
+    const std::optional<std::unique_ptr<JsonObject>> deep = JsonParser::parse_buffer(make_deep_document(2000), options);
+    const std::optional<std::unique_ptr<JsonObject>> wide = JsonParser::parse_buffer(make_manifest_document(100000));
+    const int null_fd = open("/dev/null", O_WRONLY);
+    if (!deep.has_value() || !wide.has_value() || null_fd < 0) {
+        return 1;
+    }
+    std::printf("%-6s %-8s %13s %12s %12s\n", "tree", "format", "size", "memory MB/s", "fd MB/s");
+    const bool good = measure("deep", deep.value().get(), null_fd) && measure("wide", wide.value().get(), null_fd);
+    close(null_fd);
+    return good ? 0 : 1;
+}
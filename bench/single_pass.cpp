@@ -0,0 +1,24 @@
+#include "bench.hpp"
+
+#include <json/lexer.hpp>
+#include <json/parser.hpp>
+
+/// Compares the two-stage path, which materializes the token vector before parsing it, with the fused single-pass parser
+int main() {
+    std::printf("%10s %10s %14s %14s %12s %12s\n", "packages", "input MB", "two-stage ms", "single-pass ms", "two-stage", "single-pass");
+    for (const size_t packages : {1000, 20000, 200000}) {
+        const std::string json = make_manifest_document(packages);
+        size_t token_bytes = 0;
+        const double two_stage_ms = best_of(5, [&] {
+            const JsonTokenList tokens = JsonLexer::scan_buffer(json);
+            token_bytes = tokens.tokens.capacity() * sizeof(JsonToken) + tokens.brace_match.capacity() * sizeof(uint32_t);
+            keep(JsonParser::parse(tokens));
+        });
+        const double single_pass_ms = best_of(5, [&] { keep(JsonParser::parse_buffer(json)); });
+        std::printf("%10zu %10.1f %14.2f %14.2f %9.0f MB/s %9.0f MB/s\n", packages, static_cast<double>(json.length()) / 1e6,
+            two_stage_ms, single_pass_ms, mb_per_s(json.length(), two_stage_ms), mb_per_s(json.length(), single_pass_ms));
+        std::printf("%10s token storage of the two-stage path: %.1f MB, %.2fx the input\n", "", static_cast<double>(token_bytes) / 1e6,
+            static_cast<double>(token_bytes) / static_cast<double>(json.length()));
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include "bench.hpp"
+
+#include <json/lexer.hpp>
+#include <json/simd.hpp>
+
+#include <vector>
+
+/// Searches the closing quote of a string body with every available kernel and with the dispatching `find_quote` the lexer uses,
+/// then lexes a whole document of long strings with the scalar scan and with the block scan `scan_buffer` uses
+int main() {
+    std::printf("closing quote after N bytes, GB/s\n");
+    std::printf("%8s %10s %10s %10s %10s\n", "N", "byte loop", "SSE2", "AVX2", "find_quote");
+    for (const size_t length : {16, 64, 256, 1024, 4096, 65536}) {
+        // One long buffer of bodies, each ending in a quote, so every search starts right after the previous quote
+        const size_t bodies = 64 * 1024 * 1024 / (length + 1);
+        std::string buffer;
+        for (size_t i = 0; i < bodies; i++) {
+            buffer.append(length, 'x');
+            buffer += '"';
+        }
+        const auto search = [&buffer](auto find) {
+            size_t pos = 0;
+            size_t found = 0;
+            while (pos < buffer.length()) {
+                pos = find(buffer.data(), pos, buffer.length()) + 1;
+                found++;
+            }
+            keep(found);
+        };
+        const double scalar_ms = best_of(5, [&] { search(JsonSimd::find_quote_tail); });
+#if JSON_MINI_X86_SIMD
+        const double sse2_ms = best_of(5, [&] { search(JsonSimd::find_quote_sse2); });
+        const double avx2_ms = JsonSimd::has_avx2() ? best_of(5, [&] { search(JsonSimd::find_quote_avx2); }) : 0;
+#else
+        const double sse2_ms = 0;
+        const double avx2_ms = 0;
+#endif
+        const double dispatch_ms = best_of(5, [&] { search(JsonSimd::find_quote); });
+        const auto gb_per_s = [&buffer](const double ms) { return ms == 0 ? 0 : mb_per_s(buffer.length(), ms) / 1e3; };
+        std::printf("%8zu %10.1f %10.1f %10.1f %10.1f\n", length, gb_per_s(scalar_ms), gb_per_s(sse2_ms), gb_per_s(avx2_ms),
+            gb_per_s(dispatch_ms));
+    }
+
+    const std::string json = make_long_strings_document(16 * 1024, 4096);
+    std::vector<JsonToken> tokens;
+    const double scalar_ms = best_of(5, [&] {
+        tokens.clear();
+        JsonLexer::scan_scalar(json, tokens);
+    });
+    const double scan_ms = best_of(5, [&] { keep(JsonLexer::scan_buffer(json)); });
+    std::printf("%zu MB of long strings: scan_scalar %.0f MB/s, scan_buffer %.0f MB/s\n", json.length() / 1000000,
+        mb_per_s(json.length(), scalar_ms), mb_per_s(json.length(), scan_ms));
+    return 0;
+}
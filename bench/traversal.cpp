@@ -0,0 +1,67 @@
+#include "bench.hpp"
+
+#include <json/parser.hpp>
+
+/// @function `walk_dynamic_cast`
+/// @brief Walks the tree the way it was done before the kind tag, by trying every concrete type through RTTI
+static size_t walk_dynamic_cast(const JsonObject *object) {
+    if (const auto group = dynamic_cast<const JsonGroup *>(object)) {
+        size_t sum = 1;
+        for (const auto &field : group->fields) {
+            sum += walk_dynamic_cast(field.get());
+        }
+        return sum;
+    } else if (const auto string = dynamic_cast<const JsonString *>(object)) {
+        return string->value.length();
+    } else if (const auto number = dynamic_cast<const JsonNumber *>(object)) {
+        return static_cast<size_t>(number->number.int64_value);
+    }
+    return 0;
+}
+
+/// @function `walk_kind`
+/// @brief Walks the tree with a switch on the kind tag
+static size_t walk_kind(const JsonObject *object) {
+    switch (object->kind) {
+        case JsonObjectKind::GROUP: {
+            size_t sum = 1;
+            for (const auto &field : static_cast<const JsonGroup *>(object)->fields) {
+                sum += walk_kind(field.get());
+            }
+            return sum;
+        }
+        case JsonObjectKind::STRING:
+            return static_cast<const JsonString *>(object)->value.length();
+        case JsonObjectKind::NUMBER:
+            break;
+    }
+    return static_cast<size_t>(static_cast<const JsonNumber *>(object)->number.int64_value);
+}
+
+/// @function `count_nodes`
+/// @brief Returns the number of nodes in the tree
+static size_t count_nodes(const JsonObject *object) {
+    size_t count = 1;
+    if (const auto group = object->as<JsonGroup>()) {
+        for (const auto &field : group->fields) {
+            count += count_nodes(field.get());
+        }
+    }
+    return count;
+}
+
+/// Walks a tree of about one million nodes through a dynamic_cast chain and through the kind tag
+int main() {
+    const std::optional<std::unique_ptr<JsonObject>> root = JsonParser::parse_buffer(make_manifest_document(125000));
+    if (!root.has_value()) {
+        return 1;
+    }
+    const JsonObject *tree = root.value().get();
+    size_t sums[2] = {0, 0};
+    const double dynamic_cast_ms = best_of(7, [&] { sums[0] = walk_dynamic_cast(tree); });
+    const double kind_ms = best_of(7, [&] { sums[1] = walk_kind(tree); });
+    std::printf("traversal of %zu nodes\n", count_nodes(tree));
+    std::printf("  dynamic_cast chain  %7.2f ms\n", dynamic_cast_ms);
+    std::printf("  kind tag switch     %7.2f ms\n", kind_ms);
+    return sums[0] == sums[1] ? 0 : 1;
+}
@@ -1,8 +1,8 @@
 #!/usr/bin/env sh
+set -e
 
-clang ./test/test.cpp -o testing -Iinclude -lstdc++ -std=c++17 \
-    -g \
-    -O0 \
+CXX="${CXX:-clang}"
+FLAGS="-Iinclude -lstdc++ -std=c++17 \
     -Wall \
     -Wextra \
     -Wno-unused-parameter \
@@ -13,4 +13,18 @@ clang ./test/test.cpp -o testing -Iinclude -lstdc++ -std=c++17 \
     -D_GNU_SOURCE \
     -D__STDC_CONSTANT_MACROS \
     -D__STDC_FORMAT_MACROS \
-    -D__STDC_LIMIT_MACROS
+    -D__STDC_LIMIT_MACROS"
+
+$CXX ./test/test.cpp -o testing $FLAGS -g -O0
+
+# Every test is a standalone binary which exits with a non-zero status if any of its checks fail
+mkdir -p build
+for test in ./test/*_test.cpp; do
+    $CXX "$test" -o "build/$(basename "$test" .cpp)" $FLAGS -g -O1 -pthread
+    "./build/$(basename "$test" .cpp)"
+done
+
+# The benchmarks are built optimized into build/, every one of them generates its own input
+for bench in ./bench/*.cpp; do
+    $CXX "$bench" -o "build/bench_$(basename "$bench" .cpp)" $FLAGS -O2 -DNDEBUG -pthread
+done
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+/// @class `JsonArena`
+/// @brief A bump allocator which owns all nodes, names and string values of one parse result. Memory is handed out from a list of
+/// chunks which grow geometrically, deallocation is a no-op and the objects left in the arena are never destroyed. The
+/// whole arena is freed in O(chunks), `reset` rewinds it while keeping its chunks, so reparsing similar documents performs no
+/// allocations at all once the arena has grown large enough
+class JsonArena : public std::pmr::memory_resource {
+  public:
+    explicit JsonArena(const size_t initial_chunk_size = 64 * 1024) :
+        next_chunk_size(initial_chunk_size) {}
+
+    JsonArena(const JsonArena &) = delete;
+    JsonArena &operator=(const JsonArena &) = delete;
+
+    ~JsonArena() override {
+        release();
+    }
+
+    /// @function `reset`
+    /// @brief Rewinds the arena to its first chunk, all objects allocated so far become invalid. The chunks are kept for reuse
+    void reset() {
+        current = 0;
+        used = 0;
+    }
+
+    /// @function `release`
+    /// @brief Frees all chunks of the arena, all objects allocated so far become invalid
+    void release() {
+        for (const Chunk &chunk : chunks) {
+            ::operator delete(chunk.data);
+        }
+        chunks.clear();
+        current = 0;
+        used = 0;
+    }
+
+    /// @function `capacity`
+    /// @brief Returns the total size of all chunks owned by the arena
+    ///
+    /// @return `size_t` The capacity of the arena in bytes
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Chunk &chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+  private:
+    /// @struct `Chunk`
+    /// @brief A single contiguous block of arena memory
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    void *do_allocate(const size_t bytes, const size_t alignment) override {
+        while (current < chunks.size()) {
+            const Chunk &chunk = chunks[current];
+            const uintptr_t start = reinterpret_cast<uintptr_t>(chunk.data) + used;
+            const uintptr_t aligned = (start + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            const size_t end = static_cast<size_t>(aligned - reinterpret_cast<uintptr_t>(chunk.data)) + bytes;
+            if (end <= chunk.size) {
+                used = end;
+                return reinterpret_cast<void *>(aligned);
+            }
+            // The rest of this chunk is too small, continue with the next one
+            current++;
+            used = 0;
+        }
+        const size_t chunk_size = std::max(next_chunk_size, bytes + alignment);
+        next_chunk_size = std::min(next_chunk_size * 2, MAX_CHUNK_SIZE);
+        chunks.push_back(Chunk{static_cast<char *>(::operator new(chunk_size)), chunk_size});
+        current = chunks.size() - 1;
+        used = 0;
+        return do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    /// @var `MAX_CHUNK_SIZE`
+    /// @brief The size at which chunk growth stops doubling
+    static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    /// @var `chunks`
+    /// @brief All chunks of the arena in allocation order
+    std::vector<Chunk> chunks;
+
+    /// @var `current`
+    /// @brief The index of the chunk allocations are currently served from
+    size_t current = 0;
+
+    /// @var `used`
+    /// @brief The number of bytes already used in the current chunk
+    size_t used = 0;
+
+    /// @var `next_chunk_size`
+    /// @brief The size of the next chunk the arena allocates
+    size_t next_chunk_size;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "error.hpp"
+#include "parser.hpp"
+#include "source.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @struct `JsonFileResult`
+/// @brief The outcome of parsing a single file of a batch
+struct JsonFileResult {
+    /// @var `object`
+    /// @brief The parsed object tree, `nullptr` if the file could not be loaded or parsed
+    std::unique_ptr<JsonObject> object;
+
+    /// @var `error`
+    /// @brief Why the file failed, including the errors the parser reported for it, empty if it was parsed successfully
+    std::string error;
+
+    /// @function `ok`
+    /// @brief Returns whether the file was parsed successfully
+    bool ok() const {
+        return object != nullptr;
+    }
+};
+
+/// @class `JsonBatchParser`
+/// @brief Parses many independent json files in parallel
+class JsonBatchParser {
+  public:
+    JsonBatchParser() = delete;
+
+    /// @function `parse_files`
+    /// @brief Parses all given files on a pool of worker threads. Workers claim the next unparsed file through a shared counter, so
+    /// a worker which is blocked on I/O or stuck on a large file never holds back the others. Every worker reuses one read buffer
+    /// for all of its files. Parse errors are not printed, every worker captures them into the result of the file they belong to
+    ///
+    /// @param `file_paths` The files to parse
+    /// @param `thread_count` The number of worker threads, `0` to use one per hardware thread. Never more than one per file
+    /// @param `options` The limits every file is parsed with
+    /// @return `std::vector<JsonFileResult>` The result of every file, in the order of `file_paths`
+    static std::vector<JsonFileResult> parse_files(const std::vector<std::filesystem::path> &file_paths, size_t thread_count = 0,
+        const JsonParseOptions &options = {}) {
+        std::vector<JsonFileResult> results(file_paths.size());
+        if (thread_count == 0) {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        thread_count = std::min(thread_count, file_paths.size());
+        std::atomic<size_t> next_file{0};
+        const auto work = [&]() {
+            std::string buffer;
+            for (size_t i = next_file.fetch_add(1, std::memory_order_relaxed); i < file_paths.size();
+                 i = next_file.fetch_add(1, std::memory_order_relaxed)) {
+                results[i] = parse_file(file_paths[i], buffer, options);
+            }
+        };
+        if (thread_count <= 1) {
+            work();
+            return results;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count - 1);
+        for (size_t i = 1; i < thread_count; i++) {
+            workers.emplace_back(work);
+        }
+        // The calling thread is the first worker
+        work();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        return results;
+    }
+
+  private:
+    /// @function `parse_file`
+    /// @brief Parses a single file of the batch, no exception leaves this function. The parse errors are captured into the result
+    ///
+    /// @param `file_path` The path of the file to parse
+    /// @param `buffer` The read buffer of the worker
+    /// @param `options` The limits to parse with
+    /// @return `JsonFileResult` The result of the file
+    static JsonFileResult parse_file(const std::filesystem::path &file_path, std::string &buffer, const JsonParseOptions &options) {
+        JsonFileResult result;
+        const JsonErrorCapture capture;
+        try {
+            JsonSource::read_file(file_path, buffer);
+            std::optional<std::unique_ptr<JsonObject>> object = JsonParser::parse_buffer(buffer, options);
+            if (object.has_value()) {
+                result.object = std::move(object.value());
+            } else {
+                result.error = "Failed to parse file " + file_path.string() + ": " + capture.message();
+            }
+        } catch (const std::exception &exception) {
+            result.error = exception.what();
+        }
+        return result;
+    }
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/// @class `JsonBits`
+/// @brief The bit and overflow helpers the lexer and the number parsing rely on. GCC and Clang builtins and MSVC intrinsics are used
+/// where available, every other compiler gets a portable fallback
+class JsonBits {
+  public:
+    JsonBits() = delete;
+
+    /// @function `count_trailing_zeros`
+    /// @brief Returns the number of zero bits below the lowest set bit
+    ///
+    /// @param `bits` The bits to count in, must not be `0`
+    /// @return `unsigned int` The index of the lowest set bit
+    static unsigned int count_trailing_zeros(const uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<unsigned int>(index);
+#else
+        unsigned int count = 0;
+        for (uint64_t rest = bits; (rest & 1) == 0; rest >>= 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    /// @function `multiply_overflows`
+    /// @brief Multiplies two numbers, reporting overflow instead of wrapping
+    ///
+    /// @param `a` The first factor
+    /// @param `b` The second factor
+    /// @param `result` Set to the product, only meaningful if there was no overflow
+    /// @return `bool` Whether the product does not fit into a `uint64_t`
+    static bool multiply_overflows(const uint64_t a, const uint64_t b, uint64_t &result) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_mul_overflow(a, b, &result);
+#else
+        result = a * b;
+        return a != 0 && result / a != b;
+#endif
+    }
+
+    /// @function `add_overflows`
+    /// @brief Adds two numbers, reporting overflow instead of wrapping
+    ///
+    /// @param `a` The first summand
+    /// @param `b` The second summand
+    /// @param `result` Set to the sum, only meaningful if there was no overflow
+    /// @return `bool` Whether the sum does not fit into a `uint64_t`
+    static bool add_overflows(const uint64_t a, const uint64_t b, uint64_t &result) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_add_overflow(a, b, &result);
+#else
+        result = a + b;
+        return result < a;
+#endif
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "arena.hpp"
+#include "parser.hpp"
+#include "source.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @class `JsonDocumentParser`
+/// @brief A reusable parser for many documents in a row. It keeps its arena, which holds the object tree and the stack of open
+/// groups, and its file read buffer between `parse` calls. Their capacity only ever grows, so once the largest document has been
+/// seen, parsing further documents of a similar size performs no allocations at all. Every parse invalidates the previous result.
+/// A parser instance is not thread-safe, use one instance per thread
+class JsonDocumentParser {
+  public:
+    explicit JsonDocumentParser(const JsonParseOptions &options = {}, const size_t initial_arena_size = 64 * 1024) :
+        options(options),
+        arena(initial_arena_size) {}
+
+    JsonDocumentParser(const JsonDocumentParser &) = delete;
+    JsonDocumentParser &operator=(const JsonDocumentParser &) = delete;
+
+    /// @function `parse`
+    /// @brief Parses the given json string in a single pass, see `JsonParser::parse_buffer`
+    ///
+    /// @param `json_string` The json string to parse, it only has to stay alive during this call
+    /// @return `std::optional<JsonObject *>` The result of the parsing, valid until the next call to `parse`, `parse_file` or
+    /// `release`
+    std::optional<JsonObject *> parse(const std::string_view json_string) {
+        arena.reset();
+        return JsonParser::parse_buffer(json_string, arena, options);
+    }
+
+    /// @function `parse_file`
+    /// @brief Reads the given json file into the retained read buffer and parses it, see `parse`. Small files are read instead of
+    /// mapped, which avoids one mapping per document
+    ///
+    /// @param `file_path` The path the json file to parse is located at
+    /// @return `std::optional<JsonObject *>` The result of the parsing, valid until the next call to `parse`, `parse_file` or
+    /// `release`
+    /// @throws `std::runtime_error` If the file could not be opened or read
+    std::optional<JsonObject *> parse_file(const std::filesystem::path &file_path) {
+        JsonSource::read_file(file_path, read_buffer);
+        return parse(read_buffer);
+    }
+
+    /// @function `release`
+    /// @brief Frees all retained memory, the last result becomes invalid
+    void release() {
+        arena.release();
+        std::string().swap(read_buffer);
+    }
+
+    /// @function `capacity`
+    /// @brief Returns the number of bytes currently retained for reuse
+    ///
+    /// @return `size_t` The capacity of the arena and the read buffer in bytes
+    size_t capacity() const {
+        return arena.capacity() + read_buffer.capacity();
+    }
+
+  private:
+    /// @var `options`
+    /// @brief The limits every document is parsed with
+    JsonParseOptions options;
+
+    /// @var `arena`
+    /// @brief Owns the object tree of the last document and the stack of open groups while parsing, rewound for every document
+    JsonArena arena;
+
+    /// @var `read_buffer`
+    /// @brief Holds the bytes of the last file read by `parse_file`
+    std::string read_buffer;
+};
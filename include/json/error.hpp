@@ -0,0 +1,66 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/// @class `JsonError`
+/// @brief The stream all parse errors are printed to. It is `std::cout` unless a `JsonErrorCapture` is active on the current thread
+class JsonError {
+  public:
+    JsonError() = delete;
+
+    /// @function `stream`
+    /// @brief Returns the stream the errors of the current thread are printed to
+    ///
+    /// @return `std::ostream &` The capture stream of the current thread if there is one, `std::cout` otherwise
+    static std::ostream &stream() {
+        return capture != nullptr ? *capture : std::cout;
+    }
+
+  private:
+    friend class JsonErrorCapture;
+
+    /// @var `capture`
+    /// @brief The stream of the innermost `JsonErrorCapture` of the current thread, `nullptr` if there is none
+    static inline thread_local std::ostream *capture = nullptr;
+};
+
+/// @class `JsonErrorCapture`
+/// @brief Collects all errors printed on the current thread while it is alive instead of printing them to `std::cout`, so threads
+/// which parse at the same time keep their errors apart. Captures nest, the previous one is restored on destruction
+class JsonErrorCapture {
+  public:
+    JsonErrorCapture() :
+        previous(JsonError::capture) {
+        JsonError::capture = &messages;
+    }
+
+    ~JsonErrorCapture() {
+        JsonError::capture = previous;
+    }
+
+    JsonErrorCapture(const JsonErrorCapture &) = delete;
+    JsonErrorCapture &operator=(const JsonErrorCapture &) = delete;
+
+    /// @function `message`
+    /// @brief Returns the errors captured so far, one per line, without the final line break
+    ///
+    /// @return `std::string` The captured errors, empty if there were none
+    std::string message() const {
+        std::string text = messages.str();
+        while (!text.empty() && text.back() == '\n') {
+            text.pop_back();
+        }
+        return text;
+    }
+
+  private:
+    /// @var `messages`
+    /// @brief The errors captured so far
+    std::ostringstream messages;
+
+    /// @var `previous`
+    /// @brief The capture stream which was active before this one
+    std::ostream *previous;
+};
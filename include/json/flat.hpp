@@ -0,0 +1,425 @@
+#pragma once
+
+#include "interner.hpp"
+#include "parser.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @class `JsonFlatDocument`
+/// @brief A json document stored as a structure of arrays. All nodes live in document order in contiguous arrays, every group is
+/// directly followed by its whole subtree. Node `0` is the `__ROOT__` group. The children of a group are iterated sequentially with
+/// `first_child` and `next_sibling`, and whole subtrees are skipped in O(1) through their subtree size. Keys are stored as 4 byte ids
+/// of a `JsonKeyInterner`, which can be shared between documents
+class JsonFlatDocument {
+  public:
+    /// @function `parse`
+    /// @brief Parses the given json string in a single pass directly into a flat document, no object tree is built
+    ///
+    /// @param `json_string` The json string to parse
+    /// @param `interner` The interner to store the keys in, pass the same interner to multiple parses to share the keys between
+    /// their documents. A new interner is created for the document if none is given
+    /// @param `options` The limits to parse with
+    /// @return `std::optional<JsonFlatDocument>` The parsed document, `std::nullopt` if parsing failed
+    static std::optional<JsonFlatDocument> parse(const std::string_view json_string,
+        std::shared_ptr<JsonKeyInterner> interner = nullptr, const JsonParseOptions &options = {}) {
+        JsonFlatDocument document(std::move(interner));
+        Builder builder{document, {}, {}};
+        if (!JsonParser::parse_events(json_string, builder, options)) {
+            return std::nullopt;
+        }
+        return document;
+    }
+
+    /// @function `from_tree`
+    /// @brief Converts the given object tree into a flat document
+    ///
+    /// @param `object` The root of the tree to convert. If it is not a group it becomes the only field of the `__ROOT__` group
+    /// @param `interner` The interner to store the keys in, a new interner is created for the document if none is given
+    /// @return `JsonFlatDocument` The converted document
+    static JsonFlatDocument from_tree(const JsonObject *object, std::shared_ptr<JsonKeyInterner> interner = nullptr) {
+        JsonFlatDocument document(std::move(interner));
+        if (object->kind == JsonObjectKind::GROUP) {
+            document.add_tree(object);
+        } else {
+            const uint32_t root = document.add_node(JsonObjectKind::GROUP, "__ROOT__", 1);
+            document.add_tree(object);
+            document.close_group(root);
+        }
+        return document;
+    }
+
+    /// @function `to_tree`
+    /// @brief Converts the subtree starting at the given node into an object tree. The nodes are visited in document order with the
+    /// open groups on an explicit stack, so documents of any depth can be converted
+    ///
+    /// @param `node` The node to convert, the whole document by default
+    /// @return `std::unique_ptr<JsonObject>` The converted tree
+    std::unique_ptr<JsonObject> to_tree(const uint32_t node = 0) const {
+        if (kinds[node] != JsonObjectKind::GROUP) {
+            return make_object(node);
+        }
+        auto root = make_group(node);
+        std::vector<TreeFrame> stack;
+        stack.push_back(TreeFrame{root.get(), end(node)});
+        for (uint32_t child = first_child(node); child != end(node); child++) {
+            // Every node belongs to the innermost open group whose subtree it lies in
+            while (child == stack.back().end) {
+                stack.back().group->build_index();
+                stack.pop_back();
+            }
+            JsonGroup *parent = stack.back().group;
+            if (kinds[child] == JsonObjectKind::GROUP) {
+                auto group = make_group(child);
+                stack.push_back(TreeFrame{group.get(), end(child)});
+                parent->fields.emplace_back(std::move(group));
+            } else {
+                parent->fields.emplace_back(make_object(child));
+            }
+        }
+        // The groups which end together with the converted node are only finished here
+        for (const TreeFrame &frame : stack) {
+            frame.group->build_index();
+        }
+        return root;
+    }
+
+    /// @function `size`
+    /// @brief Returns the number of nodes in the document
+    ///
+    /// @return `uint32_t` The number of nodes
+    uint32_t size() const {
+        return static_cast<uint32_t>(kinds.size());
+    }
+
+    /// @function `kind`
+    /// @brief Returns the kind of the given node
+    JsonObjectKind kind(const uint32_t node) const {
+        return kinds[node];
+    }
+
+    /// @function `key`
+    /// @brief Returns the name of the given node
+    std::string_view key(const uint32_t node) const {
+        return interner->view(keys[node]);
+    }
+
+    /// @function `key_id`
+    /// @brief Returns the interned id of the name of the given node
+    uint32_t key_id(const uint32_t node) const {
+        return keys[node];
+    }
+
+    /// @function `key_interner`
+    /// @brief Returns the interner the keys of this document are stored in
+    const std::shared_ptr<JsonKeyInterner> &key_interner() const {
+        return interner;
+    }
+
+    /// @function `find_field`
+    /// @brief Returns the direct child of the given group with the given interned key id
+    ///
+    /// @param `group` The group to search in
+    /// @param `key` The interned id of the key to search for
+    /// @return `std::optional<uint32_t>` The found child, `std::nullopt` if the group has no such child
+    std::optional<uint32_t> find_field(const uint32_t group, const uint32_t key) const {
+        for (uint32_t child = first_child(group); child != end(group); child = next_sibling(child)) {
+            if (keys[child] == key) {
+                return child;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @function `find_field`
+    /// @brief Returns the direct child of the given group with the given key
+    ///
+    /// @param `group` The group to search in
+    /// @param `key` The key to search for
+    /// @return `std::optional<uint32_t>` The found child, `std::nullopt` if the group has no such child
+    std::optional<uint32_t> find_field(const uint32_t group, const std::string_view key) const {
+        const std::optional<uint32_t> key_id = interner->find(key);
+        if (!key_id.has_value()) {
+            return std::nullopt;
+        }
+        return find_field(group, key_id.value());
+    }
+
+    /// @function `string_value`
+    /// @brief Returns the value of the given `STRING` node
+    std::string_view string_value(const uint32_t node) const {
+        return string_at(values[node]);
+    }
+
+    /// @function `number_value`
+    /// @brief Returns the value of the given `NUMBER` node
+    JsonNumberValue number_value(const uint32_t node) const {
+        return numbers[values[node]];
+    }
+
+    /// @function `child_count`
+    /// @brief Returns the number of direct children of the given `GROUP` node
+    uint32_t child_count(const uint32_t node) const {
+        return values[node];
+    }
+
+    /// @function `first_child`
+    /// @brief Returns the first child of the given group, equal to `end(node)` if the group is empty
+    uint32_t first_child(const uint32_t node) const {
+        return node + 1;
+    }
+
+    /// @function `next_sibling`
+    /// @brief Returns the node following the whole subtree of the given node
+    uint32_t next_sibling(const uint32_t node) const {
+        return node + subtree_sizes[node];
+    }
+
+    /// @function `end`
+    /// @brief Returns the first node which is not part of the subtree of the given node
+    uint32_t end(const uint32_t node) const {
+        return node + subtree_sizes[node];
+    }
+
+    /// @function `memory_usage`
+    /// @brief Returns the number of bytes used by the nodes and the string table of this document, without the shared interner
+    size_t memory_usage() const {
+        const size_t node_bytes = kinds.capacity() * sizeof(JsonObjectKind) +
+            (keys.capacity() + values.capacity() + subtree_sizes.capacity()) * sizeof(uint32_t) +
+            numbers.capacity() * sizeof(JsonNumberValue);
+        return node_bytes + string_data.capacity() + string_ends.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    explicit JsonFlatDocument(std::shared_ptr<JsonKeyInterner> interner) :
+        interner(interner != nullptr ? std::move(interner) : std::make_shared<JsonKeyInterner>()) {}
+
+    /// @function `add_string`
+    /// @brief Appends the given string to the string table
+    ///
+    /// @param `string` The string to append
+    /// @return `uint32_t` The index of the string in the string table
+    uint32_t add_string(const std::string_view string) {
+        string_data.append(string);
+        string_ends.emplace_back(static_cast<uint32_t>(string_data.length()));
+        return static_cast<uint32_t>(string_ends.size() - 1);
+    }
+
+    /// @function `add_number`
+    /// @brief Appends the given number to the number table
+    ///
+    /// @param `number` The number to append
+    /// @return `uint32_t` The index of the number in the number table
+    uint32_t add_number(const JsonNumberValue &number) {
+        numbers.emplace_back(number);
+        return static_cast<uint32_t>(numbers.size() - 1);
+    }
+
+    /// @function `string_at`
+    /// @brief Returns the string at the given index of the string table
+    std::string_view string_at(const uint32_t index) const {
+        const uint32_t start = index == 0 ? 0 : string_ends[index - 1];
+        return std::string_view(string_data).substr(start, string_ends[index] - start);
+    }
+
+    /// @function `add_node`
+    /// @brief Appends a new node with a subtree size of one
+    ///
+    /// @param `kind` The kind of the node
+    /// @param `name` The name of the node
+    /// @param `value` The string or number table index or the child count of the node
+    /// @return `uint32_t` The index of the new node
+    uint32_t add_node(const JsonObjectKind kind, const std::string_view name, const uint32_t value) {
+        kinds.emplace_back(kind);
+        keys.emplace_back(interner->intern(name));
+        values.emplace_back(value);
+        subtree_sizes.emplace_back(1);
+        return static_cast<uint32_t>(kinds.size() - 1);
+    }
+
+    /// @function `close_group`
+    /// @brief Finishes the given group once all of its children have been added
+    void close_group(const uint32_t group) {
+        subtree_sizes[group] = static_cast<uint32_t>(kinds.size()) - group;
+    }
+
+    /// @function `add_tree`
+    /// @brief Appends the given object and its whole subtree. Open groups are kept on an explicit stack, so trees of any depth can
+    /// be appended
+    ///
+    /// @param `object` The object to append
+    void add_tree(const JsonObject *object) {
+        const auto root = object->as<JsonGroup>();
+        if (root == nullptr) {
+            add_field(object);
+            return;
+        }
+        std::vector<AddFrame> stack;
+        stack.push_back(AddFrame{root, 0, add_group(root)});
+        while (!stack.empty()) {
+            AddFrame &frame = stack.back();
+            if (frame.next_field == frame.group->fields.size()) {
+                close_group(frame.node);
+                stack.pop_back();
+                continue;
+            }
+            const JsonObject *field = frame.group->fields[frame.next_field++].get();
+            if (const auto nested = field->as<JsonGroup>()) {
+                stack.push_back(AddFrame{nested, 0, add_group(nested)});
+            } else {
+                add_field(field);
+            }
+        }
+    }
+
+    /// @function `add_group`
+    /// @brief Appends the node of the given group, its fields have to be appended after it
+    ///
+    /// @return `uint32_t` The index of the new node
+    uint32_t add_group(const JsonGroup *group) {
+        return add_node(JsonObjectKind::GROUP, group->name, static_cast<uint32_t>(group->fields.size()));
+    }
+
+    /// @function `add_field`
+    /// @brief Appends the node of the given string or number field
+    void add_field(const JsonObject *object) {
+        switch (object->kind) {
+            case JsonObjectKind::GROUP:
+                // Groups are appended by `add_tree`, together with their fields
+                break;
+            case JsonObjectKind::STRING: {
+                const auto string = static_cast<const JsonString *>(object);
+                const uint32_t node = add_node(JsonObjectKind::STRING, string->name, 0);
+                values[node] = add_string(string->value);
+                break;
+            }
+            case JsonObjectKind::NUMBER: {
+                const auto number = static_cast<const JsonNumber *>(object);
+                add_node(JsonObjectKind::NUMBER, number->name, add_number(number->number));
+                break;
+            }
+        }
+    }
+
+    /// @function `make_group`
+    /// @brief Creates the empty object of the given `GROUP` node, with room for all of its children
+    std::unique_ptr<JsonGroup> make_group(const uint32_t node) const {
+        auto group = std::make_unique<JsonGroup>(key(node));
+        group->fields.reserve(values[node]);
+        return group;
+    }
+
+    /// @function `make_object`
+    /// @brief Creates the object of the given `STRING` or `NUMBER` node
+    std::unique_ptr<JsonObject> make_object(const uint32_t node) const {
+        if (kinds[node] == JsonObjectKind::STRING) {
+            return std::make_unique<JsonString>(key(node), string_value(node));
+        }
+        return std::make_unique<JsonNumber>(key(node), number_value(node));
+    }
+
+    /// @struct `TreeFrame`
+    /// @brief A group which `to_tree` is currently adding the children of
+    struct TreeFrame {
+        /// @var `group`
+        /// @brief The group the children are added to
+        JsonGroup *group;
+
+        /// @var `end`
+        /// @brief The first node after the subtree of the group
+        uint32_t end;
+    };
+
+    /// @struct `AddFrame`
+    /// @brief A group which `add_tree` is currently appending the fields of
+    struct AddFrame {
+        /// @var `group`
+        /// @brief The group being appended
+        const JsonGroup *group;
+
+        /// @var `next_field`
+        /// @brief The index of the next field of the group to append
+        size_t next_field;
+
+        /// @var `node`
+        /// @brief The node of the group
+        uint32_t node;
+    };
+
+    /// @struct `Builder`
+    /// @brief The `JsonParser::parse_events` handler which appends the parsed nodes to a document
+    struct Builder {
+        JsonFlatDocument &document;
+        std::vector<uint32_t> groups;
+        std::string_view key;
+
+        bool on_object_begin() {
+            if (!groups.empty()) {
+                document.values[groups.back()]++;
+            }
+            groups.emplace_back(document.add_node(JsonObjectKind::GROUP, groups.empty() ? "__ROOT__" : key, 0));
+            return true;
+        }
+
+        bool on_key(const std::string_view name) {
+            key = name;
+            return true;
+        }
+
+        bool on_string(const std::string_view value) {
+            document.values[groups.back()]++;
+            const uint32_t node = document.add_node(JsonObjectKind::STRING, key, 0);
+            document.values[node] = document.add_string(value);
+            return true;
+        }
+
+        bool on_number(const JsonNumberValue &number) {
+            document.values[groups.back()]++;
+            document.add_node(JsonObjectKind::NUMBER, key, document.add_number(number));
+            return true;
+        }
+
+        bool on_object_end() {
+            document.close_group(groups.back());
+            groups.pop_back();
+            return true;
+        }
+    };
+
+    /// @var `interner`
+    /// @brief The interner all keys of this document are stored in
+    std::shared_ptr<JsonKeyInterner> interner;
+
+    /// @var `kinds`
+    /// @brief The kind of every node
+    std::vector<JsonObjectKind> kinds;
+
+    /// @var `keys`
+    /// @brief The interned key id of the name of every node
+    std::vector<uint32_t> keys;
+
+    /// @var `values`
+    /// @brief The string table index for `STRING` nodes, the number table index for `NUMBER` nodes and the child count for `GROUP`
+    /// nodes
+    std::vector<uint32_t> values;
+
+    /// @var `subtree_sizes`
+    /// @brief The number of nodes in the subtree of every node, including the node itself
+    std::vector<uint32_t> subtree_sizes;
+
+    /// @var `string_data`
+    /// @brief The concatenated contents of all strings of the string table
+    std::string string_data;
+
+    /// @var `string_ends`
+    /// @brief The end offset of every string of the string table within `string_data`
+    std::vector<uint32_t> string_ends;
+
+    /// @var `numbers`
+    /// @brief The number table, the values of all `NUMBER` nodes
+    std::vector<JsonNumberValue> numbers;
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "bits.hpp"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/// @class `JsonInteger`
+/// @brief Allocation-free and exception-free conversion between decimal digits and integers. Parsing converts eight digits per
+/// step with SWAR arithmetic on a single 64 bit word and reports overflow instead of wrapping. Formatting writes two digits per
+/// step from a table of all digit pairs
+class JsonInteger {
+  public:
+    JsonInteger() = delete;
+
+    /// @var `MAX_FORMATTED_LENGTH`
+    /// @brief The maximum number of characters `format` writes, the sign included
+    static constexpr size_t MAX_FORMATTED_LENGTH = 20;
+
+    /// @function `parse`
+    /// @brief Parses a run of decimal digits into an `int`
+    ///
+    /// @param `digits` The digits to parse, without a sign
+    /// @param `value` Set to the parsed number
+    /// @return `bool` Whether the digits were valid and the number fits into an `int`
+    static bool parse(const std::string_view digits, int &value) {
+        uint64_t number;
+        if (!parse(digits, number) || number > static_cast<uint64_t>(INT_MAX)) {
+            return false;
+        }
+        value = static_cast<int>(number);
+        return true;
+    }
+
+    /// @function `parse`
+    /// @brief Parses a run of decimal digits into a `uint64_t`
+    ///
+    /// @param `digits` The digits to parse, without a sign
+    /// @param `value` Set to the parsed number
+    /// @return `bool` Whether the digits were valid and the number fits into a `uint64_t`
+    static bool parse(std::string_view digits, uint64_t &value) {
+        if (digits.empty()) {
+            return false;
+        }
+        // Leading zeros do not count towards the 20 digits a uint64_t can hold
+        const size_t first_non_zero = digits.find_first_not_of('0');
+        if (first_non_zero == std::string_view::npos) {
+            value = 0;
+            return true;
+        }
+        digits.remove_prefix(first_non_zero);
+        if (digits.length() > 20) {
+            return false;
+        }
+        // Up to 19 digits can never overflow, only the 20th digit has to be checked
+        const size_t safe_length = digits.length() < 20 ? digits.length() : 19;
+        uint64_t number = 0;
+        size_t i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        for (; i + 8 <= safe_length; i += 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, digits.data() + i, sizeof(chunk));
+            if (!is_eight_digits(chunk)) {
+                return false;
+            }
+            number = number * 100000000 + parse_eight_digits(chunk);
+        }
+#endif
+        for (; i < safe_length; i++) {
+            const uint8_t digit = static_cast<uint8_t>(digits[i] - '0');
+            if (digit > 9) {
+                return false;
+            }
+            number = number * 10 + digit;
+        }
+        if (safe_length != digits.length()) {
+            const uint8_t digit = static_cast<uint8_t>(digits[safe_length] - '0');
+            if (digit > 9 || JsonBits::multiply_overflows(number, 10, number) || JsonBits::add_overflows(number, digit, number)) {
+                return false;
+            }
+        }
+        value = number;
+        return true;
+    }
+
+    /// @function `format`
+    /// @brief Writes the decimal representation of the given number
+    ///
+    /// @param `value` The number to format
+    /// @param `buffer` The buffer to write to, it has to hold at least `MAX_FORMATTED_LENGTH` characters
+    /// @return `char *` The position right after the last written character
+    static char *format(const int value, char *buffer) {
+        return format(static_cast<int64_t>(value), buffer);
+    }
+
+    /// @function `format`
+    /// @brief Writes the decimal representation of the given number
+    ///
+    /// @param `value` The number to format
+    /// @param `buffer` The buffer to write to, it has to hold at least `MAX_FORMATTED_LENGTH` characters
+    /// @return `char *` The position right after the last written character
+    static char *format(const int64_t value, char *buffer) {
+        if (value < 0) {
+            *buffer++ = '-';
+            return format(0 - static_cast<uint64_t>(value), buffer);
+        }
+        return format(static_cast<uint64_t>(value), buffer);
+    }
+
+    /// @function `format`
+    /// @brief Writes the decimal representation of the given number
+    ///
+    /// @param `value` The number to format
+    /// @param `buffer` The buffer to write to, it has to hold at least `MAX_FORMATTED_LENGTH` characters
+    /// @return `char *` The position right after the last written character
+    static char *format(uint64_t value, char *buffer) {
+        // The digits are produced from the back, so they are counted first and written straight to their final position
+        char *const end = buffer + count_digits(value);
+        char *start = end;
+        while (value >= 100) {
+            const size_t pair = static_cast<size_t>(value % 100) * 2;
+            value /= 100;
+            start -= 2;
+            std::memcpy(start, DIGIT_PAIRS + pair, 2);
+        }
+        if (value >= 10) {
+            std::memcpy(start - 2, DIGIT_PAIRS + value * 2, 2);
+        } else {
+            start[-1] = static_cast<char>('0' + value);
+        }
+        return end;
+    }
+
+    /// @function `count_digits`
+    /// @brief Returns the number of decimal digits of the given number, `1` for zero
+    static size_t count_digits(uint64_t value) {
+        size_t digits = 1;
+        while (true) {
+            if (value < 10) {
+                return digits;
+            }
+            if (value < 100) {
+                return digits + 1;
+            }
+            if (value < 1000) {
+                return digits + 2;
+            }
+            if (value < 10000) {
+                return digits + 3;
+            }
+            value /= 10000;
+            digits += 4;
+        }
+    }
+
+  private:
+    /// @var `DIGIT_PAIRS`
+    /// @brief The two characters of every number from `00` to `99`
+    static constexpr char DIGIT_PAIRS[] = "00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899";
+
+    /// @function `is_eight_digits`
+    /// @brief Checks whether all eight characters loaded into the given word are decimal digits
+    static bool is_eight_digits(const uint64_t chunk) {
+        // Every byte has to be 0x30 to 0x39: its high nibble is 3, and adding 6 must not carry into the high nibble
+        return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    }
+
+    /// @function `parse_eight_digits`
+    /// @brief Converts eight digit characters loaded little-endian into the given word to their value. Neighbouring digits are
+    /// combined into pairs first, then all four pairs are combined by two multiplications
+    static uint32_t parse_eight_digits(uint64_t chunk) {
+        chunk -= 0x3030303030303030;
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+                    (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+            32;
+        return static_cast<uint32_t>(chunk);
+    }
+};
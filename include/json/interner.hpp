@@ -0,0 +1,81 @@
+#pragma once
+
+#include "arena.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// @class `JsonKeyInterner`
+/// @brief A table of unique keys. Every distinct key is stored exactly once and gets a stable 4 byte id, so documents sharing an
+/// interner store their keys as ids and compare keys with a single integer compare. The interner is not thread-safe
+class JsonKeyInterner {
+  public:
+    JsonKeyInterner() = default;
+
+    JsonKeyInterner(const JsonKeyInterner &) = delete;
+    JsonKeyInterner &operator=(const JsonKeyInterner &) = delete;
+
+    /// @function `intern`
+    /// @brief Returns the id of the given key, adding the key to the table if it is not known yet
+    ///
+    /// @param `key` The key to intern
+    /// @return `uint32_t` The stable id of the key
+    uint32_t intern(const std::string_view key) {
+        const auto it = ids.find(key);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        char *stored = static_cast<char *>(storage.allocate(key.length() + 1, 1));
+        std::memcpy(stored, key.data(), key.length());
+        const std::string_view stored_key(stored, key.length());
+        const uint32_t id = static_cast<uint32_t>(keys.size());
+        keys.emplace_back(stored_key);
+        ids.emplace(stored_key, id);
+        return id;
+    }
+
+    /// @function `find`
+    /// @brief Returns the id of the given key without adding it to the table
+    ///
+    /// @param `key` The key to look up
+    /// @return `std::optional<uint32_t>` The id of the key, `std::nullopt` if the key has never been interned
+    std::optional<uint32_t> find(const std::string_view key) const {
+        const auto it = ids.find(key);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// @function `view`
+    /// @brief Returns the key with the given id
+    ///
+    /// @param `id` The id of the key
+    /// @return `std::string_view` The key, valid for the lifetime of the interner
+    std::string_view view(const uint32_t id) const {
+        return keys[id];
+    }
+
+    /// @function `size`
+    /// @brief Returns the number of distinct keys in the table
+    size_t size() const {
+        return keys.size();
+    }
+
+  private:
+    /// @var `storage`
+    /// @brief Owns the bytes of all keys, they never move once interned
+    JsonArena storage{4096};
+
+    /// @var `keys`
+    /// @brief The key of every id
+    std::vector<std::string_view> keys;
+
+    /// @var `ids`
+    /// @brief The id of every key
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "bits.hpp"
+#include "error.hpp"
+#include "simd.hpp"
+#include "source.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 /// @class `JsonTokenType`
 /// @brief Represents all possible tokens of a json file
-enum class JsonTokenType {
+enum class JsonTokenType : uint8_t {
     TOK_LEFT_BRACE,
     TOK_RIGHT_BRACE,
     TOK_COLON,
@@ -17,20 +28,103 @@ enum class JsonTokenType {
 };
 
 /// @struct `JsonToken`
-/// @brief A simple json token
+/// @brief A simple json token, it only references its content inside the source buffer it was scanned from
 struct JsonToken {
   public:
-    JsonToken(const JsonTokenType type, const std::string &content) :
-        type(type),
-        content(content) {}
+    JsonToken(const JsonTokenType type, const uint64_t offset, const uint32_t length) :
+        offset(offset),
+        length(length),
+        type(type) {}
+
+    /// @var `offset`
+    /// @brief The byte offset of the content of the token within the source buffer
+    uint64_t offset;
+
+    /// @var `length`
+    /// @brief The length of the content of the token in bytes
+    uint32_t length;
 
     /// @var `type`
     /// @brief The type of the token
     JsonTokenType type;
+};
+static_assert(sizeof(JsonToken) == 16, "JsonToken should stay compact");
+
+/// @struct `JsonTokenList`
+/// @brief A list of scanned json tokens together with the source buffer their contents live in
+struct JsonTokenList {
+  public:
+    /// @var `source`
+    /// @brief The source the tokens were scanned from, kept alive by the token list
+    std::shared_ptr<const JsonSource> source;
+
+    /// @var `tokens`
+    /// @brief The scanned tokens
+    std::vector<JsonToken> tokens;
+
+    /// @var `brace_match`
+    /// @brief For every `TOK_LEFT_BRACE` the index of its matching `TOK_RIGHT_BRACE`, or `tokens.size()` if it is never closed. The
+    /// entries of all other tokens are unused. Built by `index_braces`
+    std::vector<uint32_t> brace_match;
+
+    /// @function `text`
+    /// @brief Resolves the content of the given token
+    ///
+    /// @param `token` The token to resolve, must be part of this list
+    /// @return `std::string_view` The content of the token, valid for as long as the source is alive
+    std::string_view text(const JsonToken &token) const {
+        return source->view().substr(token.offset, token.length);
+    }
+
+    /// @function `index_braces`
+    /// @brief Builds the `brace_match` table in one linear pass over the tokens
+    ///
+    /// @return `bool` Whether the table could be built, it can not address more than `UINT32_MAX` tokens
+    bool index_braces() {
+        return match_braces(tokens, brace_match);
+    }
+
+    /// @function `has_brace_index`
+    /// @brief Returns whether the `brace_match` table covers the current tokens. Lists whose tokens were added by hand, for example
+    /// from `JsonStreamLexer`, have no table until `index_braces` is called
+    bool has_brace_index() const {
+        return brace_match.size() == tokens.size();
+    }
+
+    /// @function `match_braces`
+    /// @brief Builds a brace table for the given tokens in one linear pass, see `brace_match`
+    ///
+    /// @param `tokens` The tokens to index
+    /// @param `table` Set to the index of the matching `}` of every `{`
+    /// @return `bool` Whether the table could be built, it can not address more than `UINT32_MAX` tokens
+    static bool match_braces(const std::vector<JsonToken> &tokens, std::vector<uint32_t> &table) {
+        if (tokens.size() >= UINT32_MAX) {
+            return false;
+        }
+        table.assign(tokens.size(), static_cast<uint32_t>(tokens.size()));
+        std::vector<uint32_t> open_braces;
+        for (uint32_t i = 0; i < tokens.size(); i++) {
+            if (tokens[i].type == JsonTokenType::TOK_LEFT_BRACE) {
+                open_braces.emplace_back(i);
+            } else if (tokens[i].type == JsonTokenType::TOK_RIGHT_BRACE && !open_braces.empty()) {
+                table[open_braces.back()] = i;
+                open_braces.pop_back();
+            }
+        }
+        return true;
+    }
+
+    size_t size() const {
+        return tokens.size();
+    }
 
-    /// @var `content`
-    /// @brief The content of the token
-    std::string content;
+    bool empty() const {
+        return tokens.empty();
+    }
+
+    const JsonToken &operator[](const size_t index) const {
+        return tokens[index];
+    }
 };
 
 class JsonLexer {
@@ -41,38 +135,102 @@ class JsonLexer {
     /// @brief Scans the given file and returns a list of all json tokens
     ///
     /// @param `file_path` The path the json file to scan is located at
-    /// @return `std::vector<JsonToken>` A list of all scanned tokens
-    static std::vector<JsonToken> scan(const std::filesystem::path &file_path) {
-        // Load the given file
-        std::ifstream file(file_path.string());
-        if (!file) {
-            throw std::runtime_error("Failed to load file " + file_path.string());
-        }
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        const std::string json_string = buffer.str();
-
-        // Lex the given file
-        std::vector<JsonToken> tokens;
-        size_t start = 0;
-        for (size_t end = 0; end < json_string.length(); end++) {
-            switch (json_string[end]) {
+    /// @return `JsonTokenList` A list of all scanned tokens
+    static JsonTokenList scan(const std::filesystem::path &file_path) {
+        // Load the given file, the lexer walks the mapped bytes directly
+        return scan(JsonSource::from_file(file_path));
+    }
+
+    /// @function `scan_buffer`
+    /// @brief Scans the given in-memory json string without copying it and returns a list of all json tokens
+    ///
+    /// @param `json_string` The json string to scan, has to outlive the returned token list
+    /// @return `JsonTokenList` A list of all scanned tokens
+    static JsonTokenList scan_buffer(const std::string_view json_string) {
+        return scan(JsonSource::from_view(json_string));
+    }
+
+    /// @function `scan`
+    /// @brief Scans the given source and returns a list of all json tokens
+    ///
+    /// @param `source` The source to scan
+    /// @return `JsonTokenList` A list of all scanned tokens, keeping the source alive
+    static JsonTokenList scan(std::shared_ptr<const JsonSource> source) {
+        JsonTokenList list;
+        list.source = std::move(source);
+        const std::string_view json_string = list.source->view();
+        // Dense documents have about one token per four bytes, reserving that up front keeps the vector from regrowing. Pages of the
+        // reservation which are never written to are never touched
+        list.tokens.reserve(json_string.length() / 4);
+#if JSON_MINI_X86_SIMD
+        const bool success = JsonSimd::has_avx2() ? scan_blocks<JsonSimd::classify_avx2>(json_string, list.tokens)
+                                                  : scan_blocks<JsonSimd::classify_sse2>(json_string, list.tokens);
+#else
+        const bool success = scan_scalar(json_string, list.tokens);
+#endif
+        if (!success) {
+            return {};
+        }
+        if (!list.index_braces()) {
+            JsonError::stream() << "Error: Json file contains too many tokens" << std::endl;
+            return {};
+        }
+        return list;
+    }
+
+    /// @function `scan_scalar`
+    /// @brief Scans the given json string one byte at a time, this is the reference the vectorized `scan_blocks` has to match
+    ///
+    /// @param `json_string` The json string to scan
+    /// @param `tokens` The list the scanned tokens are appended to
+    /// @return `bool` Whether scanning succeeded, the error has already been printed if it did not
+    static bool scan_scalar(const std::string_view json_string, std::vector<JsonToken> &tokens) {
+        size_t pos = 0;
+        std::optional<JsonToken> token;
+        while (next_token(json_string, pos, token)) {
+            if (!token.has_value()) {
+                return true;
+            }
+            tokens.emplace_back(token.value());
+        }
+        return false;
+    }
+
+    /// @function `next_token`
+    /// @brief Lexes the next token of the given json string, starting at `pos`. This is the pull interface used by the single-pass
+    /// parser, it never materializes a token list
+    ///
+    /// @param `json_string` The json string to lex
+    /// @param `pos` The position to continue lexing at, is moved past the lexed token
+    /// @param `token` Set to the lexed token, or to `std::nullopt` if the end of the json string has been reached
+    /// @return `bool` Whether lexing succeeded, the error has already been printed if it did not
+    static bool next_token(const std::string_view json_string, size_t &pos, std::optional<JsonToken> &token) {
+        for (; pos < json_string.length(); pos++) {
+            switch (json_string[pos]) {
                 default:
-                    if (is_digit(json_string[end])) {
-                        end++;
-                        while (json_string.begin() + end != json_string.end() && is_digit(json_string[end])) {
-                            end++;
+                    if (is_number_char(json_string[pos])) {
+                        // Valid numbers are consumed by the grammar walk alone, the token only extends further if it is invalid
+                        const size_t start = pos;
+                        const bool matched = match_number(json_string, pos);
+                        const size_t match_end = pos;
+                        while (pos != json_string.length() && is_number_char(json_string[pos])) {
+                            pos++;
+                        }
+                        if (pos == json_string.length()) {
+                            JsonError::stream() << "Error: Json file ended with a number, not with a '}'" << std::endl;
+                            return false;
                         }
-                        if (json_string.begin() + end == json_string.end()) {
-                            std::cout << "Error: Json file ended with a number, not with a '}'" << std::endl;
-                            return {};
+                        if (!matched || pos != match_end) {
+                            JsonError::stream() << "Error: Invalid number in json string: '" << json_string.substr(start, pos - start)
+                                                << "'" << std::endl;
+                            return false;
                         }
-                        tokens.emplace_back(JsonTokenType::TOK_NUMBER, json_string.substr(start, end - start));
-                        start = end;
-                        break;
+                        // The character after the number has not been lexed yet
+                        token.emplace(JsonTokenType::TOK_NUMBER, start, static_cast<uint32_t>(pos - start));
+                        return true;
                     }
-                    std::cout << "Error: Unknown character in json string: '" << json_string[end] << "'" << std::endl;
-                    return {};
+                    JsonError::stream() << "Error: Unknown character in json string: '" << json_string[pos] << "'" << std::endl;
+                    return false;
                 case '\n':
                     [[fallthrough]];
                 case '\t':
@@ -80,40 +238,156 @@ class JsonLexer {
                 case '\r':
                     [[fallthrough]];
                 case ' ':
-                    start = end;
                     break;
                 case '{':
-                    tokens.emplace_back(JsonTokenType::TOK_LEFT_BRACE, "{");
-                    start = end;
-                    break;
+                    token.emplace(JsonTokenType::TOK_LEFT_BRACE, pos++, 1);
+                    return true;
                 case '}':
-                    tokens.emplace_back(JsonTokenType::TOK_RIGHT_BRACE, "}");
-                    start = end;
-                    break;
+                    token.emplace(JsonTokenType::TOK_RIGHT_BRACE, pos++, 1);
+                    return true;
                 case ':':
-                    tokens.emplace_back(JsonTokenType::TOK_COLON, ":");
-                    start = end;
-                    break;
+                    token.emplace(JsonTokenType::TOK_COLON, pos++, 1);
+                    return true;
                 case ',':
-                    tokens.emplace_back(JsonTokenType::TOK_COMMA, ",");
-                    start = end;
-                    break;
-                case '"':
-                    end++;
-                    start = end;
-                    while (json_string.begin() + end != json_string.end() && json_string[end] != '"') {
-                        end++;
+                    token.emplace(JsonTokenType::TOK_COMMA, pos++, 1);
+                    return true;
+                case '"': {
+                    const size_t start = pos + 1;
+                    pos = JsonSimd::find_quote(json_string.data(), start, json_string.length());
+                    if (pos == json_string.length()) {
+                        JsonError::stream() << "Error: Unterminated string value at the end of the json string" << std::endl;
+                        return false;
                     }
-                    if (json_string.begin() + end == json_string.end()) {
-                        std::cout << "Error: Unterminated string value at the end of the json string" << std::endl;
-                        return {};
+                    if (pos - start > UINT32_MAX) {
+                        JsonError::stream() << "Error: String value exceeds the maximum token length" << std::endl;
+                        return false;
                     }
-                    tokens.emplace_back(JsonTokenType::TOK_STR_VAL, json_string.substr(start, end - start));
-                    start = end;
-                    break;
+                    token.emplace(JsonTokenType::TOK_STR_VAL, start, static_cast<uint32_t>(pos - start));
+                    pos++; // Skip the closing "
+                    return true;
+                }
+            }
+        }
+        token.reset();
+        return true;
+    }
+
+    /// @function `scan_blocks`
+    /// @brief Scans the given json string one block at a time. The `classify` kernel turns every block into bitmasks of its quotes,
+    /// structural characters, whitespace and number characters, the tokens are then emitted from the set bits of these masks in
+    /// position order. Produces exactly the same tokens and errors as `scan_scalar`
+    ///
+    /// @tparam `classify` The kernel used to classify a single block
+    /// @param `json_string` The json string to scan
+    /// @param `tokens` The list the scanned tokens are appended to
+    /// @return `bool` Whether scanning succeeded, the error has already been printed if it did not
+    template <JsonBlockMasks (*classify)(const char *)>
+    static bool scan_blocks(const std::string_view json_string, std::vector<JsonToken> &tokens) {
+        const size_t length = json_string.length();
+        // Whether the previous block ended inside a string or a number
+        bool string_carry = false;
+        bool number_carry = false;
+        // Whether a string or number token has been started but not yet emitted
+        bool string_open = false;
+        bool number_open = false;
+        size_t token_start = 0;
+        char padded[JsonSimd::BLOCK_SIZE];
+        for (size_t base = 0, next_base = 0; base < length; base = next_base) {
+            next_base = base + JsonSimd::BLOCK_SIZE;
+            const char *block = json_string.data() + base;
+            uint64_t valid = ~uint64_t(0);
+            if (length - base < JsonSimd::BLOCK_SIZE) {
+                // Pad the last block with whitespace, the padding never produces any tokens
+                std::memset(padded, ' ', JsonSimd::BLOCK_SIZE);
+                std::memcpy(padded, block, length - base);
+                block = padded;
+                valid = (uint64_t(1) << (length - base)) - 1;
+            }
+            const JsonBlockMasks masks = classify(block);
+            const uint64_t inside = JsonSimd::prefix_xor(masks.quote) ^ (string_carry ? ~uint64_t(0) : 0);
+            string_carry = (inside >> 63) != 0;
+            const uint64_t outside = ~(inside | masks.quote);
+            const uint64_t structural = masks.structural & outside;
+            const uint64_t numbers = masks.number & outside;
+            const uint64_t numbers_before = (numbers << 1) | (number_carry ? 1 : 0);
+            number_carry = (numbers >> 63) != 0;
+            const uint64_t number_starts = numbers & ~numbers_before;
+            const uint64_t number_ends = ~numbers & numbers_before;
+            const uint64_t unknown = outside & ~(masks.whitespace | masks.structural | masks.number);
+
+            uint64_t events = (structural | masks.quote | number_starts | number_ends | unknown) & valid;
+            while (events != 0) {
+                const unsigned int bit_idx = JsonBits::count_trailing_zeros(events);
+                const uint64_t bit = uint64_t(1) << bit_idx;
+                const size_t pos = base + bit_idx;
+                events &= events - 1;
+                // A number ends at the first character after it, which still has to be lexed itself
+                if (number_ends & bit) {
+                    if (!check_number(json_string.substr(token_start, pos - token_start))) {
+                        return false;
+                    }
+                    tokens.emplace_back(JsonTokenType::TOK_NUMBER, token_start, static_cast<uint32_t>(pos - token_start));
+                    number_open = false;
+                }
+                if (unknown & bit) {
+                    JsonError::stream() << "Error: Unknown character in json string: '" << json_string[pos] << "'" << std::endl;
+                    return false;
+                } else if (number_starts & bit) {
+                    token_start = pos;
+                    number_open = true;
+                } else if (masks.quote & bit) {
+                    if (inside & bit) {
+                        token_start = pos + 1;
+                        string_open = true;
+                        // A string which is not closed within the block is searched to its end with `find_quote`, and classification
+                        // restarts right after its closing quote. Nothing else in the rest of the block can be an event
+                        if ((masks.quote >> bit_idx >> 1) == 0 && next_base < length) {
+                            const size_t end = JsonSimd::find_quote(json_string.data(), next_base, length);
+                            next_base = end == length ? length : end;
+                            string_carry = end != length;
+                            number_carry = false;
+                            break;
+                        }
+                        continue;
+                    }
+                    if (pos - token_start > UINT32_MAX) {
+                        JsonError::stream() << "Error: String value exceeds the maximum token length" << std::endl;
+                        return false;
+                    }
+                    tokens.emplace_back(JsonTokenType::TOK_STR_VAL, token_start, static_cast<uint32_t>(pos - token_start));
+                    string_open = false;
+                } else if (structural & bit) {
+                    tokens.emplace_back(structural_type(json_string[pos]), pos, 1);
+                }
             }
         }
-        return tokens;
+        if (number_open) {
+            JsonError::stream() << "Error: Json file ended with a number, not with a '}'" << std::endl;
+            return false;
+        }
+        if (string_open) {
+            JsonError::stream() << "Error: Unterminated string value at the end of the json string" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /// @function `structural_type`
+    /// @brief Returns the token type of the given structural character
+    ///
+    /// @param `c` The structural character, one of `{`, `}`, `:` or `,`
+    /// @return `JsonTokenType` The token type of the character
+    static JsonTokenType structural_type(const char c) {
+        switch (c) {
+            case '{':
+                return JsonTokenType::TOK_LEFT_BRACE;
+            case '}':
+                return JsonTokenType::TOK_RIGHT_BRACE;
+            case ':':
+                return JsonTokenType::TOK_COLON;
+            default:
+                return JsonTokenType::TOK_COMMA;
+        }
     }
 
     /// @function `is_digit`
@@ -125,12 +399,106 @@ class JsonLexer {
         return c >= '0' && c <= '9';
     }
 
+    /// @function `is_number_char`
+    /// @brief Returns whether a given character can be part of a number token, a digit, sign, decimal point or exponent marker
+    ///
+    /// @param `c` The character to check
+    /// @return `bool` Whether the character can be part of a number
+    static bool is_number_char(char c) {
+        // `+`, `-`, `.` and the digits all lie within the 15 characters starting at `+`, the bitmask selects them from that range
+        const unsigned int offset = static_cast<unsigned char>(c) - static_cast<unsigned int>('+');
+        return (offset < 15 && ((0x7FED >> offset) & 1) != 0) || c == 'e' || c == 'E';
+    }
+
+    /// @function `is_valid_number`
+    /// @brief Returns whether the given text matches the json number grammar `-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?`
+    ///
+    /// @param `text` The text of the number token
+    /// @return `bool` Whether the text is a valid json number
+    static bool is_valid_number(const std::string_view text) {
+        size_t pos = 0;
+        return match_number(text, pos) && pos == text.length();
+    }
+
+    /// @function `match_number`
+    /// @brief Walks the json number grammar from `pos` on, consuming characters as long as they continue a number
+    ///
+    /// @param `text` The text to walk
+    /// @param `pos` The position to start at, is moved to the first character which does not continue the number
+    /// @return `bool` Whether the consumed characters form a complete number
+    static bool match_number(const std::string_view text, size_t &pos) {
+        const size_t length = text.length();
+        if (pos != length && text[pos] == '-') {
+            pos++;
+        }
+        if (pos == length || !is_digit(text[pos])) {
+            return false;
+        }
+        // The integer part has no leading zeros
+        if (text[pos++] != '0') {
+            skip_digits(text, pos);
+        }
+        if (pos != length && text[pos] == '.') {
+            pos++;
+            if (pos == length || !is_digit(text[pos])) {
+                return false;
+            }
+            skip_digits(text, pos);
+        }
+        if (pos != length && (text[pos] == 'e' || text[pos] == 'E')) {
+            pos++;
+            if (pos != length && (text[pos] == '+' || text[pos] == '-')) {
+                pos++;
+            }
+            if (pos == length || !is_digit(text[pos])) {
+                return false;
+            }
+            skip_digits(text, pos);
+        }
+        return true;
+    }
+
+    /// @function `skip_digits`
+    /// @brief Moves `pos` past the run of digits starting at it, checking eight characters per step where possible
+    static void skip_digits(const std::string_view text, size_t &pos) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        while (pos + 8 <= text.length()) {
+            uint64_t chunk;
+            std::memcpy(&chunk, text.data() + pos, sizeof(chunk));
+            // The high bit of a byte is set if it is at least 0x80, above '9' or below '0'. Carries and borrows only start at
+            // non-digit bytes, so the lowest flagged byte always is the first non-digit
+            const uint64_t non_digits = (chunk | (chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080;
+            if (non_digits != 0) {
+                pos += JsonBits::count_trailing_zeros(non_digits) / 8;
+                return;
+            }
+            pos += 8;
+        }
+#endif
+        while (pos != text.length() && is_digit(text[pos])) {
+            pos++;
+        }
+    }
+
+    /// @function `check_number`
+    /// @brief Checks the text of a lexed number token against the json number grammar
+    ///
+    /// @param `text` The text of the number token
+    /// @return `bool` Whether the number is valid, the error has already been printed if it is not
+    static bool check_number(const std::string_view text) {
+        if (!is_valid_number(text)) {
+            JsonError::stream() << "Error: Invalid number in json string: '" << text << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     /// @function `print_tokens`
     /// @brief Prints a given list of JsonTokens to the console
     ///
     /// @param `tokens` The list of tokens to print
-    static void print_tokens(const std::vector<JsonToken> &tokens) {
-        for (const auto &tok : tokens) {
+    static void print_tokens(const JsonTokenList &tokens) {
+        for (const auto &tok : tokens.tokens) {
             switch (tok.type) {
                 case JsonTokenType::TOK_LEFT_BRACE:
                     std::cout << "TOK_LEFT_BRACE: ";
@@ -151,7 +519,7 @@ class JsonLexer {
                     std::cout << "TOK_NUMBER: ";
                     break;
             }
-            std::cout << tok.content << std::endl;
+            std::cout << tokens.text(tok) << std::endl;
         }
     }
 };
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "document_parser.hpp"
+#include "parser.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/// @class `JsonLinesReader`
+/// @brief Reads newline-delimited json (NDJSON / JSON Lines), one document per line, and hands out one parsed record at a time.
+/// All records are parsed by the same `JsonDocumentParser`, so its arena is rewound and reused for every record. Streams are read
+/// in chunks into a window which only ever holds the current record and the unread rest of the last chunk, so memory stays
+/// proportional to the largest record instead of the whole input. Empty and whitespace-only lines are skipped
+class JsonLinesReader {
+  public:
+    JsonLinesReader(const JsonLinesReader &) = delete;
+    JsonLinesReader &operator=(const JsonLinesReader &) = delete;
+
+    ~JsonLinesReader() {
+        if (owns_fd) {
+            close(fd);
+        }
+    }
+
+    /// @function `from_buffer`
+    /// @brief Creates a reader over the records of an in-memory buffer, the buffer is not copied
+    ///
+    /// @param `buffer` The records to read, has to outlive the reader
+    /// @param `options` The limits every record is parsed with
+    /// @return `JsonLinesReader` The reader
+    static JsonLinesReader from_buffer(const std::string_view buffer, const JsonParseOptions &options = {}) {
+        return JsonLinesReader(buffer, -1, false, options);
+    }
+
+    /// @function `from_file`
+    /// @brief Creates a reader which streams the records of the given file
+    ///
+    /// @param `file_path` The path of the file to read
+    /// @param `options` The limits every record is parsed with
+    /// @return `JsonLinesReader` The reader, owning the opened file
+    /// @throws `std::runtime_error` If the file could not be opened
+    static JsonLinesReader from_file(const std::filesystem::path &file_path, const JsonParseOptions &options = {}) {
+        const int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+        return JsonLinesReader({}, fd, true, options);
+    }
+
+    /// @function `from_fd`
+    /// @brief Creates a reader which streams the records of the given file descriptor, for example a pipe
+    ///
+    /// @param `fd` The file descriptor to read from, it is not closed by the reader
+    /// @param `options` The limits every record is parsed with
+    /// @return `JsonLinesReader` The reader
+    static JsonLinesReader from_fd(const int fd, const JsonParseOptions &options = {}) {
+        return JsonLinesReader({}, fd, false, options);
+    }
+
+    /// @function `next`
+    /// @brief Parses the next record
+    ///
+    /// @param `record` Set to the parsed record, or reset once the input is exhausted. The record stays valid until the next call
+    /// @return `bool` Whether the record could be parsed, the error has already been printed if it could not. The failed record is
+    /// skipped, so calling `next` again continues with the following line
+    /// @throws `std::runtime_error` If reading from the stream failed
+    bool next(std::optional<JsonObject *> &record) {
+        std::string_view line;
+        while (true) {
+            if (!next_line(line)) {
+                record.reset();
+                return true;
+            }
+            if (line.find_first_not_of(" \t\r") != std::string_view::npos) {
+                break;
+            }
+        }
+        record = parser.parse(line);
+        return record.has_value();
+    }
+
+    /// @function `line`
+    /// @brief Returns the line number of the last line which has been read, starting at `1`
+    size_t line() const {
+        return line_number;
+    }
+
+  private:
+    JsonLinesReader(const std::string_view buffer, const int fd, const bool owns_fd, const JsonParseOptions &options) :
+        parser(options),
+        buffer(buffer),
+        fd(fd),
+        owns_fd(owns_fd) {}
+
+    /// @var `CHUNK_SIZE`
+    /// @brief The number of bytes requested from the stream per read
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    /// @function `next_line`
+    /// @brief Returns the next line of the input, without its `\n`
+    ///
+    /// @param `line` Set to the next line, only valid until the next call
+    /// @return `bool` Whether there was another line
+    bool next_line(std::string_view &line) {
+        while (true) {
+            const char *newline = scanned < buffer.length()
+                ? static_cast<const char *>(std::memchr(buffer.data() + scanned, '\n', buffer.length() - scanned))
+                : nullptr;
+            if (newline != nullptr) {
+                const size_t end = static_cast<size_t>(newline - buffer.data());
+                line = buffer.substr(start, end - start);
+                start = end + 1;
+                scanned = start;
+                line_number++;
+                return true;
+            }
+            scanned = buffer.length();
+            if (fd >= 0 && !stream_ended) {
+                read_chunk();
+                continue;
+            }
+            if (start == buffer.length()) {
+                return false;
+            }
+            // The last line is not terminated by a newline
+            line = buffer.substr(start);
+            start = buffer.length();
+            scanned = start;
+            line_number++;
+            return true;
+        }
+    }
+
+    /// @function `read_chunk`
+    /// @brief Drops all consumed lines from the window and appends the next chunk of the stream to it
+    void read_chunk() {
+        window.erase(0, start);
+        scanned -= start;
+        start = 0;
+        const size_t old_length = window.length();
+        window.resize(old_length + CHUNK_SIZE);
+        ssize_t bytes_read;
+        do {
+            bytes_read = read(fd, window.data() + old_length, CHUNK_SIZE);
+        } while (bytes_read < 0 && errno == EINTR);
+        if (bytes_read < 0) {
+            window.resize(old_length);
+            buffer = window;
+            throw std::runtime_error("Failed to read json lines from the stream");
+        }
+        window.resize(old_length + static_cast<size_t>(bytes_read));
+        stream_ended = bytes_read == 0;
+        buffer = window;
+    }
+
+    /// @var `parser`
+    /// @brief Parses every record, reusing its arena
+    JsonDocumentParser parser;
+
+    /// @var `buffer`
+    /// @brief The input which is currently available, the whole buffer in buffer mode and the window in stream mode
+    std::string_view buffer;
+
+    /// @var `window`
+    /// @brief Holds the unconsumed bytes read from the stream
+    std::string window;
+
+    /// @var `start`
+    /// @brief The position within `buffer` at which the next line starts
+    size_t start = 0;
+
+    /// @var `scanned`
+    /// @brief The position within `buffer` up to which no newline has been found
+    size_t scanned = 0;
+
+    /// @var `line_number`
+    /// @brief The number of lines read so far
+    size_t line_number = 0;
+
+    /// @var `fd`
+    /// @brief The file descriptor of the stream, `-1` in buffer mode
+    int fd;
+
+    /// @var `owns_fd`
+    /// @brief Whether the file descriptor is closed by the reader
+    bool owns_fd;
+
+    /// @var `stream_ended`
+    /// @brief Whether the end of the stream has been reached
+    bool stream_ended = false;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "integer.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/// @enum `JsonNumberType`
+/// @brief How a json number is stored
+enum class JsonNumberType : uint8_t {
+    /// Integers which fit into an `int64_t`
+    INT64,
+    /// Positive integers above `INT64_MAX` which still fit into a `uint64_t`
+    UINT64,
+    /// Numbers with a fraction or an exponent, and integers too large for both integer types
+    DOUBLE,
+};
+
+/// @class `JsonNumberValue`
+/// @brief A json number (RFC 8259), stored as the narrowest of `int64_t`, `uint64_t` and `double` which holds it exactly. Integers
+/// are always stored as `INT64` if they fit, no matter whether they were parsed or created from a signed or unsigned C++ integer
+class JsonNumberValue {
+  public:
+    /// @var `MAX_FORMATTED_LENGTH`
+    /// @brief The maximum number of characters `format` writes
+    static constexpr size_t MAX_FORMATTED_LENGTH = 32;
+
+    JsonNumberValue() :
+        type(JsonNumberType::INT64),
+        int64_value(0) {}
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>, int> = 0>
+    JsonNumberValue(const T value) :
+        type(JsonNumberType::INT64),
+        int64_value(static_cast<int64_t>(value)) {}
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    JsonNumberValue(const T value) {
+        if (static_cast<uint64_t>(value) > static_cast<uint64_t>(INT64_MAX)) {
+            type = JsonNumberType::UINT64;
+            uint64_value = static_cast<uint64_t>(value);
+        } else {
+            type = JsonNumberType::INT64;
+            int64_value = static_cast<int64_t>(value);
+        }
+    }
+
+    /// @throws `std::invalid_argument` If the value is NaN or infinite, json has no representation for them
+    JsonNumberValue(const double value) :
+        type(JsonNumberType::DOUBLE),
+        double_value(value) {
+        if (!std::isfinite(value)) {
+            throw std::invalid_argument("Json numbers can not be NaN or infinite");
+        }
+    }
+
+    /// @function `parse`
+    /// @brief Converts the text of a number token. Integers are converted exactly with `JsonInteger`, everything else is converted
+    /// to the nearest `double` by `std::from_chars`
+    ///
+    /// @param `text` The text of the number, it has to match the json number grammar (see `JsonLexer::is_valid_number`)
+    /// @param `value` Set to the converted number
+    /// @return `bool` Whether the number could be converted, numbers beyond the range of a `double` can not
+    static bool parse(const std::string_view text, JsonNumberValue &value) {
+        const bool negative = !text.empty() && text.front() == '-';
+        const std::string_view digits = negative ? text.substr(1) : text;
+        uint64_t magnitude;
+        // A fraction or exponent stops the integer conversion at its first character, so no separate scan for them is needed
+        if (JsonInteger::parse(digits, magnitude)) {
+            if (!negative) {
+                value = JsonNumberValue(magnitude);
+                return true;
+            }
+            if (magnitude <= uint64_t(1) << 63) {
+                value = JsonNumberValue(static_cast<int64_t>(0 - magnitude));
+                return true;
+            }
+        }
+        double number;
+        const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.length(), number);
+        if (result.ptr != text.data() + text.length()) {
+            return false;
+        }
+        if (result.ec == std::errc::result_out_of_range) {
+            // Numbers too close to zero round to zero, only numbers too large for a double are rejected
+            if (!is_below_one(text)) {
+                return false;
+            }
+            number = negative ? -0.0 : 0.0;
+        } else if (result.ec != std::errc()) {
+            return false;
+        }
+        value = JsonNumberValue(number);
+        return true;
+    }
+
+    /// @function `format`
+    /// @brief Writes the number. Doubles are written in their shortest form which parses back to the same value, and always with a
+    /// fraction or an exponent, so they are read back as doubles again
+    ///
+    /// @param `buffer` The buffer to write to, it has to hold at least `MAX_FORMATTED_LENGTH` characters
+    /// @return `char *` The position right after the last written character
+    char *format(char *buffer) const {
+        switch (type) {
+            case JsonNumberType::INT64:
+                return JsonInteger::format(int64_value, buffer);
+            case JsonNumberType::UINT64:
+                return JsonInteger::format(uint64_value, buffer);
+            case JsonNumberType::DOUBLE:
+                break;
+        }
+        char *end = std::to_chars(buffer, buffer + MAX_FORMATTED_LENGTH - 2, double_value).ptr;
+        if (std::string_view(buffer, static_cast<size_t>(end - buffer)).find_first_of(".eE") == std::string_view::npos) {
+            std::memcpy(end, ".0", 2);
+            end += 2;
+        }
+        return end;
+    }
+
+    /// @function `to_double`
+    /// @brief Returns the number as a `double`, integers beyond 2^53 are rounded
+    double to_double() const {
+        switch (type) {
+            case JsonNumberType::INT64:
+                return static_cast<double>(int64_value);
+            case JsonNumberType::UINT64:
+                return static_cast<double>(uint64_value);
+            case JsonNumberType::DOUBLE:
+                break;
+        }
+        return double_value;
+    }
+
+    bool operator==(const JsonNumberValue &other) const {
+        if (type != other.type) {
+            return false;
+        }
+        switch (type) {
+            case JsonNumberType::INT64:
+                return int64_value == other.int64_value;
+            case JsonNumberType::UINT64:
+                return uint64_value == other.uint64_value;
+            case JsonNumberType::DOUBLE:
+                break;
+        }
+        return double_value == other.double_value;
+    }
+
+    bool operator!=(const JsonNumberValue &other) const {
+        return !(*this == other);
+    }
+
+  private:
+    /// @function `is_below_one`
+    /// @brief Returns whether the magnitude of the given number is below one, by comparing the decimal exponent of its first
+    /// significant digit with zero
+    ///
+    /// @param `text` The text of the number, it has to match the json number grammar
+    /// @return `bool` Whether the magnitude of the number is below one
+    static bool is_below_one(const std::string_view text) {
+        const size_t exponent_start = text.find_first_of("eE");
+        const std::string_view mantissa = text.substr(0, exponent_start);
+        const size_t first_significant = mantissa.find_first_of("123456789");
+        if (first_significant == std::string_view::npos) {
+            return true;
+        }
+        const size_t point = mantissa.find('.');
+        const size_t integer_end = point == std::string_view::npos ? mantissa.length() : point;
+        int64_t exponent = first_significant < integer_end ? static_cast<int64_t>(integer_end - first_significant - 1)
+                                                           : -static_cast<int64_t>(first_significant - integer_end);
+        if (exponent_start != std::string_view::npos) {
+            size_t pos = exponent_start + 1;
+            const bool negative = text[pos] == '-';
+            if (text[pos] == '-' || text[pos] == '+') {
+                pos++;
+            }
+            // The explicit exponent saturates, anything this large is far beyond the range of a double either way
+            int64_t explicit_exponent = 0;
+            for (; pos < text.length() && explicit_exponent < 1000000000; pos++) {
+                explicit_exponent = explicit_exponent * 10 + (text[pos] - '0');
+            }
+            exponent += negative ? -explicit_exponent : explicit_exponent;
+        }
+        return exponent < 0;
+    }
+
+  public:
+    /// @var `type`
+    /// @brief Which of the values is stored
+    JsonNumberType type;
+
+    union {
+        /// @var `int64_value`
+        /// @brief The value of `INT64` numbers
+        int64_t int64_value;
+
+        /// @var `uint64_value`
+        /// @brief The value of `UINT64` numbers
+        uint64_t uint64_value;
+
+        /// @var `double_value`
+        /// @brief The value of `DOUBLE` numbers
+        double double_value;
+    };
+};
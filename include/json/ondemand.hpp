@@ -0,0 +1,217 @@
+#pragma once
+
+#include "error.hpp"
+#include "lexer.hpp"
+#include "number.hpp"
+#include "simd.hpp"
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @class `JsonCursor`
+/// @brief An on-demand view of a single value inside a raw json buffer. No object tree is built: `find_field` walks the members of
+/// a group and steps over every non-matching value, whole nested groups are skipped by brace matching without lexing their content,
+/// and values are only decoded when they are accessed. The cost therefore scales with what is read, not with the document size.
+/// Skipped content is not validated. The buffer has to outlive every cursor into it
+class JsonCursor {
+  public:
+    /// @function `open`
+    /// @brief Returns a cursor to the root group of the given json string
+    ///
+    /// @param `json_string` The json string to navigate
+    /// @return `std::optional<JsonCursor>` The cursor to the root group, `std::nullopt` if the json string does not start with a group
+    static std::optional<JsonCursor> open(const std::string_view json_string) {
+        size_t pos = 0;
+        std::optional<JsonToken> token;
+        if (!JsonLexer::next_token(json_string, pos, token)) {
+            return std::nullopt;
+        }
+        if (!token.has_value() || token.value().type != JsonTokenType::TOK_LEFT_BRACE) {
+            JsonError::stream() << "Error: expected '{' at the start of the json string" << std::endl;
+            return std::nullopt;
+        }
+        return JsonCursor(json_string, token.value());
+    }
+
+    /// @function `type`
+    /// @brief Returns the type of the value, `TOK_LEFT_BRACE` for groups
+    JsonTokenType type() const {
+        return token.type;
+    }
+
+    /// @function `is_group`
+    /// @brief Returns whether the value is a group
+    bool is_group() const {
+        return token.type == JsonTokenType::TOK_LEFT_BRACE;
+    }
+
+    /// @function `find_field`
+    /// @brief Returns a cursor to the value of the first field of this group with the given name, skipping all other fields
+    ///
+    /// @param `key` The name of the field to find
+    /// @return `std::optional<JsonCursor>` The cursor to the value, `std::nullopt` if this is not a group, it has no such field or the
+    /// group is malformed
+    std::optional<JsonCursor> find_field(const std::string_view key) const {
+        std::optional<JsonCursor> found;
+        for_each_field([&](const std::string_view name, const JsonCursor &value) {
+            if (name == key) {
+                found = value;
+                return false;
+            }
+            return true;
+        });
+        return found;
+    }
+
+    /// @function `for_each_field`
+    /// @brief Calls the callback for every field of this group, in document order
+    ///
+    /// @param `callback` Called as `bool callback(std::string_view name, const JsonCursor &value)`, iteration stops once it returns
+    /// false
+    /// @return `bool` Whether the fields could be walked until the callback stopped or the group ended
+    template <typename Callback> bool for_each_field(Callback &&callback) const {
+        if (!is_group()) {
+            return false;
+        }
+        size_t pos = token.offset + 1;
+        std::optional<JsonToken> next;
+        if (!JsonLexer::next_token(json_string, pos, next)) {
+            return false;
+        }
+        if (next.has_value() && next.value().type == JsonTokenType::TOK_RIGHT_BRACE) {
+            return true;
+        }
+        while (true) {
+            if (!next.has_value() || next.value().type != JsonTokenType::TOK_STR_VAL) {
+                JsonError::stream() << "Error: expected a name inside the group" << std::endl;
+                return false;
+            }
+            const std::string_view name = json_string.substr(next.value().offset, next.value().length);
+            if (!JsonLexer::next_token(json_string, pos, next)) {
+                return false;
+            }
+            if (!next.has_value() || next.value().type != JsonTokenType::TOK_COLON) {
+                JsonError::stream() << "Error: expected ':' after name" << std::endl;
+                return false;
+            }
+            if (!JsonLexer::next_token(json_string, pos, next)) {
+                return false;
+            }
+            if (!next.has_value() || next.value().type == JsonTokenType::TOK_RIGHT_BRACE ||
+                next.value().type == JsonTokenType::TOK_COLON || next.value().type == JsonTokenType::TOK_COMMA) {
+                JsonError::stream() << "Error: expected a value after ':'" << std::endl;
+                return false;
+            }
+            const JsonCursor value(json_string, next.value());
+            if (!callback(name, value)) {
+                return true;
+            }
+            if (value.is_group()) {
+                pos = skip_group(json_string, value.token.offset);
+                if (pos == json_string.length()) {
+                    JsonError::stream() << "Error: expected '}' at the end of the group" << std::endl;
+                    return false;
+                }
+            }
+            if (!JsonLexer::next_token(json_string, pos, next)) {
+                return false;
+            }
+            if (!next.has_value()) {
+                JsonError::stream() << "Error: expected '}' at the end of the group" << std::endl;
+                return false;
+            }
+            if (next.value().type == JsonTokenType::TOK_RIGHT_BRACE) {
+                return true;
+            }
+            if (next.value().type != JsonTokenType::TOK_COMMA) {
+                JsonError::stream() << "Error: expected ',' or '}' after a field" << std::endl;
+                return false;
+            }
+            if (!JsonLexer::next_token(json_string, pos, next)) {
+                return false;
+            }
+        }
+    }
+
+    /// @function `get_string`
+    /// @brief Returns the value as a string
+    ///
+    /// @return `std::optional<std::string_view>` The string value, pointing into the buffer, `std::nullopt` if it is no string
+    std::optional<std::string_view> get_string() const {
+        if (token.type != JsonTokenType::TOK_STR_VAL) {
+            return std::nullopt;
+        }
+        return json_string.substr(token.offset, token.length);
+    }
+
+    /// @function `get_number`
+    /// @brief Decodes the value as a number
+    ///
+    /// @return `std::optional<JsonNumberValue>` The number value, `std::nullopt` if it is no number or does not fit into a `double`
+    std::optional<JsonNumberValue> get_number() const {
+        JsonNumberValue number;
+        if (token.type != JsonTokenType::TOK_NUMBER || !JsonNumberValue::parse(json_string.substr(token.offset, token.length), number)) {
+            return std::nullopt;
+        }
+        return number;
+    }
+
+    /// @function `raw`
+    /// @brief Returns the raw bytes of the value, whole groups included
+    ///
+    /// @return `std::string_view` The raw bytes of the value, pointing into the buffer
+    std::string_view raw() const {
+        if (is_group()) {
+            return json_string.substr(token.offset, skip_group(json_string, token.offset) - token.offset);
+        }
+        return json_string.substr(token.offset, token.length);
+    }
+
+    /// @function `skip_group`
+    /// @brief Skips the group starting at the given `{` by brace matching, strings are stepped over as a whole so braces inside them
+    /// are ignored
+    ///
+    /// @param `json_string` The json string containing the group
+    /// @param `pos` The position of the opening `{`
+    /// @return `size_t` The position right after the matching `}`, the length of the json string if the group is never closed
+    static size_t skip_group(const std::string_view json_string, size_t pos) {
+        size_t depth = 0;
+        for (; pos < json_string.length(); pos++) {
+            switch (json_string[pos]) {
+                case '"':
+                    pos = JsonSimd::find_quote(json_string.data(), pos + 1, json_string.length());
+                    if (pos == json_string.length()) {
+                        return pos;
+                    }
+                    break;
+                case '{':
+                    depth++;
+                    break;
+                case '}':
+                    depth--;
+                    if (depth == 0) {
+                        return pos + 1;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return json_string.length();
+    }
+
+  private:
+    JsonCursor(const std::string_view json_string, const JsonToken &token) :
+        json_string(json_string),
+        token(token) {}
+
+    /// @var `json_string`
+    /// @brief The whole json buffer the cursor points into
+    std::string_view json_string;
+
+    /// @var `token`
+    /// @brief The first token of the value, the opening `{` for groups
+    JsonToken token;
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "number.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <unistd.h>
+
+/// @enum `JsonFormat`
+/// @brief The layout json text is written in
+enum class JsonFormat : uint8_t {
+    /// One field per line, indented with one tab per nesting level
+    PRETTY,
+    /// No insignificant whitespace at all
+    COMPACT,
+};
+
+/// @class `JsonOutputBuffer`
+/// @brief The output all json text is written into. Everything is appended to a single growable buffer. In-memory output keeps
+/// it, output to a file descriptor flushes it whenever it grows past the flush threshold, so writing a large document to a file
+/// only ever holds one threshold worth of text. The buffer keeps its capacity when it is cleared or flushed. A failed write to the
+/// file descriptor is sticky, all later text is discarded and `good` reports the failure
+class JsonOutputBuffer {
+  public:
+    /// @brief Creates an in-memory output
+    JsonOutputBuffer() = default;
+
+    /// @brief Creates an output which is written to the given file descriptor
+    ///
+    /// @param `fd` The file descriptor to write to, it is not closed by the output
+    /// @param `flush_threshold` The number of buffered bytes at which the buffer is written out
+    explicit JsonOutputBuffer(const int fd, const size_t flush_threshold = 64 * 1024) :
+        fd(fd),
+        flush_threshold(flush_threshold) {
+        data.reserve(flush_threshold);
+    }
+
+    JsonOutputBuffer(const JsonOutputBuffer &) = delete;
+    JsonOutputBuffer &operator=(const JsonOutputBuffer &) = delete;
+
+    /// @brief Writes out the rest of the buffered text, call `flush` first to find out whether that succeeded
+    ~JsonOutputBuffer() {
+        flush();
+    }
+
+    /// @function `append`
+    /// @brief Appends the given text
+    void append(const std::string_view text) {
+        data.append(text);
+        flush_if_full();
+    }
+
+    /// @function `append`
+    /// @brief Appends a single character
+    void append(const char c) {
+        data.push_back(c);
+        flush_if_full();
+    }
+
+    /// @function `append_number`
+    /// @brief Appends the given number, doubles in their shortest round-trip form
+    void append_number(const JsonNumberValue &number) {
+        // Room for the longest number is added behind the text, the number is formatted in place and the rest is cut off again
+        const size_t size = data.size();
+        data.resize(size + JsonNumberValue::MAX_FORMATTED_LENGTH);
+        const char *end = number.format(data.data() + size);
+        data.resize(static_cast<size_t>(end - data.data()));
+        flush_if_full();
+    }
+
+    /// @function `indent`
+    /// @brief Appends the indentation of the given level, one tab per level, copied from a precomputed run of tabs
+    void indent(size_t level) {
+        static constexpr std::string_view TABS = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+        while (level > TABS.length()) {
+            data.append(TABS);
+            level -= TABS.length();
+        }
+        data.append(TABS.substr(0, level));
+        flush_if_full();
+    }
+
+    /// @function `write_indent`
+    /// @brief Starts a new line of the given nesting level, only pretty output has indentation
+    void write_indent(const JsonFormat format, const size_t level) {
+        if (format == JsonFormat::PRETTY) {
+            indent(level);
+        }
+    }
+
+    /// @function `write_name`
+    /// @brief Starts a field of the given nesting level by writing its name and the `:` separating it from its value
+    void write_name(const JsonFormat format, const size_t level, const std::string_view name) {
+        write_indent(format, level);
+        append('"');
+        append(name);
+        append(format == JsonFormat::PRETTY ? std::string_view("\": ") : std::string_view("\":"));
+    }
+
+    /// @function `write_string`
+    /// @brief Writes a string value, the content is written as is
+    void write_string(const std::string_view value) {
+        append('"');
+        append(value);
+        append('"');
+    }
+
+    /// @function `write_separator`
+    /// @brief Writes the separator between two fields of a group
+    void write_separator(const JsonFormat format) {
+        append(format == JsonFormat::PRETTY ? std::string_view(",\n") : std::string_view(","));
+    }
+
+    /// @function `write_group_open`
+    /// @brief Writes the `{` opening a group, after its name if it has one
+    void write_group_open(const JsonFormat format) {
+        append(format == JsonFormat::PRETTY ? std::string_view("{\n") : std::string_view("{"));
+    }
+
+    /// @function `write_group_close`
+    /// @brief Writes the `}` closing a group of the given nesting level
+    ///
+    /// @param `format` The layout to write in
+    /// @param `level` The nesting level of the group itself
+    /// @param `has_fields` Whether any field has been written into the group
+    void write_group_close(const JsonFormat format, const size_t level, const bool has_fields) {
+        if (format == JsonFormat::PRETTY) {
+            if (has_fields) {
+                append('\n');
+            }
+            indent(level);
+        }
+        append('}');
+    }
+
+    /// @function `flush`
+    /// @brief Writes all buffered text to the file descriptor, does nothing for in-memory output. Once a write has failed, the
+    /// buffered text is discarded instead
+    ///
+    /// @return `bool` Whether all text written so far reached the file descriptor
+    bool flush() {
+        if (fd < 0) {
+            return true;
+        }
+        if (failed) {
+            data.clear();
+            return false;
+        }
+        size_t written = 0;
+        while (written < data.length()) {
+            const ssize_t result = write(fd, data.data() + written, data.length() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                failed = true;
+                data.clear();
+                return false;
+            }
+            written += static_cast<size_t>(result);
+        }
+        data.clear();
+        return true;
+    }
+
+    /// @function `good`
+    /// @brief Returns whether no write to the file descriptor has failed so far, always `true` for in-memory output
+    bool good() const {
+        return !failed;
+    }
+
+    /// @function `view`
+    /// @brief Returns the buffered text, all text written so far for in-memory output
+    std::string_view view() const {
+        return data;
+    }
+
+    /// @function `take`
+    /// @brief Hands out the buffered text and leaves the buffer empty
+    std::string take() {
+        std::string text = std::move(data);
+        data.clear();
+        return text;
+    }
+
+    /// @function `clear`
+    /// @brief Discards the buffered text, the capacity is kept for reuse
+    void clear() {
+        data.clear();
+    }
+
+  private:
+    /// @function `flush_if_full`
+    /// @brief Writes the buffered text out once it has grown past the flush threshold, a failure is kept for `good`
+    void flush_if_full() {
+        if (fd >= 0 && data.length() >= flush_threshold) {
+            flush();
+        }
+    }
+
+    /// @var `data`
+    /// @brief The buffered text
+    std::string data;
+
+    /// @var `fd`
+    /// @brief The file descriptor the text is written to, `-1` for in-memory output
+    int fd = -1;
+
+    /// @var `flush_threshold`
+    /// @brief The number of buffered bytes at which the buffer is written out
+    size_t flush_threshold = 0;
+
+    /// @var `failed`
+    /// @brief Whether a write to the file descriptor has failed, no text is written anymore once it has
+    bool failed = false;
+};
@@ -1,226 +1,993 @@
 #pragma once
 
+#include "arena.hpp"
+#include "error.hpp"
+#include "number.hpp"
 #include "lexer.hpp"
+#include "output.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/// @enum `JsonObjectKind`
+/// @brief The concrete type of a json object, used to dispatch on objects without RTTI
+enum class JsonObjectKind : uint8_t {
+    GROUP,
+    STRING,
+    NUMBER,
+};
+
 /// @class `JsonObject`
-/// @brief Virtual abstract base class to represent all json objects
+/// @brief Virtual abstract base class to represent all json objects. All names, string values and field lists are allocated from a
+/// `std::pmr::memory_resource`, which is the default heap resource unless the tree is built inside a `JsonArena`
 class JsonObject {
   public:
     virtual ~JsonObject() = default;
+
+    /// @function `as`
+    /// @brief Casts the object to the given concrete type by checking its kind tag
+    ///
+    /// @return `T *` The object as the concrete type, `nullptr` if it is of another kind
+    template <typename T> T *as() {
+        return kind == T::KIND ? static_cast<T *>(this) : nullptr;
+    }
+
+    template <typename T> const T *as() const {
+        return kind == T::KIND ? static_cast<const T *>(this) : nullptr;
+    }
+
+    /// @function `visit`
+    /// @brief Calls the visitor with the object as its concrete type, dispatched through a switch on the kind tag
+    ///
+    /// @param `visitor` Callable with `const JsonGroup &`, `const JsonString &` and `const JsonNumber &`
+    /// @return The result of the visitor
+    template <typename Visitor> decltype(auto) visit(Visitor &&visitor) const;
+
+    /// @function `is_in_arena`
+    /// @brief Returns whether the object was created inside a `JsonArena`, its memory then belongs to the arena
+    bool is_in_arena() const {
+        return in_arena;
+    }
+
+    /// @var `kind`
+    /// @brief The concrete type of the object
+    const JsonObjectKind kind;
+
+  private:
+    friend class JsonDomBuilder;
+
+    /// @var `in_arena`
+    /// @brief Whether the object was created inside a `JsonArena`, declared next to `kind` so it fits into its padding
+    bool in_arena = false;
+
+  public:
+    /// @var `name`
+    /// @brief The name of the object
+    std::pmr::string name;
+
+  protected:
+    JsonObject(const JsonObjectKind kind, const std::string_view name, std::pmr::memory_resource *resource) :
+        kind(kind),
+        name(name, resource) {}
+};
+
+/// @struct `JsonObjectDeleter`
+/// @brief The deleter of all fields. Heap objects are deleted, objects inside a `JsonArena` are only destroyed, as their memory is
+/// released by the arena. It converts from `std::default_delete`, so pointers from `std::make_unique` can be stored as fields
+struct JsonObjectDeleter {
+    JsonObjectDeleter() = default;
+
+    template <typename T, typename = std::enable_if_t<std::is_convertible_v<T *, JsonObject *>>>
+    JsonObjectDeleter(const std::default_delete<T> &) {}
+
+    void operator()(JsonObject *object) const {
+        if (object->is_in_arena()) {
+            object->~JsonObject();
+        } else {
+            delete object;
+        }
+    }
+};
+
+/// @typedef `JsonObjectPtr`
+/// @brief An owning pointer to a field of a group, on the heap or inside a `JsonArena`
+using JsonObjectPtr = std::unique_ptr<JsonObject, JsonObjectDeleter>;
+
+/// @class `JsonFieldList`
+/// @brief The field list of a group. It behaves like a vector of fields, but counts every operation which adds or removes fields, so
+/// the lookup index of the group notices any structural change, even one which keeps the number of fields the same
+class JsonFieldList {
+  public:
+    using value_type = JsonObjectPtr;
+    using iterator = std::pmr::vector<JsonObjectPtr>::iterator;
+    using const_iterator = std::pmr::vector<JsonObjectPtr>::const_iterator;
+
+    explicit JsonFieldList(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+        fields(resource) {}
+
+    size_t size() const {
+        return fields.size();
+    }
+
+    bool empty() const {
+        return fields.empty();
+    }
+
+    iterator begin() {
+        return fields.begin();
+    }
+
+    iterator end() {
+        return fields.end();
+    }
+
+    const_iterator begin() const {
+        return fields.begin();
+    }
+
+    const_iterator end() const {
+        return fields.end();
+    }
+
+    JsonObjectPtr &operator[](const size_t i) {
+        return fields[i];
+    }
+
+    const JsonObjectPtr &operator[](const size_t i) const {
+        return fields[i];
+    }
+
+    JsonObjectPtr &at(const size_t i) {
+        return fields.at(i);
+    }
+
+    const JsonObjectPtr &at(const size_t i) const {
+        return fields.at(i);
+    }
+
+    JsonObjectPtr &back() {
+        return fields.back();
+    }
+
+    const JsonObjectPtr &back() const {
+        return fields.back();
+    }
+
+    void reserve(const size_t capacity) {
+        fields.reserve(capacity);
+    }
+
+    template <typename... Args> JsonObjectPtr &emplace_back(Args &&...args) {
+        mutations++;
+        return fields.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void push_back(JsonObjectPtr field) {
+        mutations++;
+        fields.push_back(std::move(field));
+    }
+
+    iterator insert(const const_iterator position, JsonObjectPtr field) {
+        mutations++;
+        return fields.insert(position, std::move(field));
+    }
+
+    iterator erase(const const_iterator position) {
+        mutations++;
+        return fields.erase(position);
+    }
+
+    iterator erase(const const_iterator first, const const_iterator last) {
+        mutations++;
+        return fields.erase(first, last);
+    }
+
+    void pop_back() {
+        mutations++;
+        fields.pop_back();
+    }
+
+    void clear() {
+        mutations++;
+        fields.clear();
+    }
+
+    /// @function `generation`
+    /// @brief Returns the number of operations which added or removed fields so far
+    size_t generation() const {
+        return mutations;
+    }
+
+  private:
+    /// @var `fields`
+    /// @brief The fields in document order
+    std::pmr::vector<JsonObjectPtr> fields;
+
+    /// @var `mutations`
+    /// @brief The number of operations which added or removed fields so far
+    size_t mutations = 0;
 };
 
 /// @class `JsonGroup`
 /// @brief Class to represent a group (`"...": {...}`)
 class JsonGroup : public JsonObject {
   public:
-    JsonGroup(const std::string &name, std::vector<std::unique_ptr<JsonObject>> &fields) :
-        name(name),
-        fields(std::move(fields)) {}
+    static constexpr JsonObjectKind KIND = JsonObjectKind::GROUP;
 
-    /// @var `name`
-    /// @brief The name of the group
-    std::string name;
+    JsonGroup(const std::string_view name, std::vector<std::unique_ptr<JsonObject>> &fields) :
+        JsonObject(KIND, name, std::pmr::get_default_resource()),
+        index(std::pmr::get_default_resource()) {
+        this->fields.reserve(fields.size());
+        std::move(fields.begin(), fields.end(), std::back_inserter(this->fields));
+        fields.clear();
+    }
+
+    explicit JsonGroup(const std::string_view name, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+        JsonObject(KIND, name, resource),
+        fields(resource),
+        index(resource) {}
+
+    /// @brief Destroys the whole subtree without recursing once per nesting level and without allocating. It walks down the last
+    /// fields to the deepest non-empty group, links every group it passes to its parent, and pops fields from the bottom up, so every
+    /// nested group is already empty when it is destroyed
+    ~JsonGroup() override {
+        JsonGroup *group = this;
+        while (true) {
+            if (group->fields.empty()) {
+                if (group == this) {
+                    break;
+                }
+                // The emptied group is the last field of its parent, it is popped in the next round
+                group = group->destroying_parent;
+                continue;
+            }
+            JsonObjectPtr &last = group->fields.back();
+            if (last != nullptr && last->kind == KIND && !static_cast<JsonGroup *>(last.get())->fields.empty()) {
+                JsonGroup *nested = static_cast<JsonGroup *>(last.get());
+                nested->destroying_parent = group;
+                group = nested;
+            } else {
+                group->fields.pop_back();
+            }
+        }
+    }
+
+    /// @var `INDEX_THRESHOLD`
+    /// @brief Groups with at least this many fields get a hash index, smaller groups are searched linearly
+    static constexpr size_t INDEX_THRESHOLD = 16;
+
+    /// @function `find`
+    /// @brief Returns the first field with the given name. Groups with at least `INDEX_THRESHOLD` fields are looked up through their
+    /// hash index. The parsers build it for every group they finish, a non-const lookup rebuilds it after the fields were changed. A
+    /// const lookup never modifies the group, without a current index it searches linearly, so concurrent const lookups are safe
+    ///
+    /// @param `key` The name of the field to find
+    /// @return `JsonObject *` The found field, `nullptr` if the group has no field with that name
+    JsonObject *find(const std::string_view key) {
+        build_index();
+        return const_cast<JsonObject *>(std::as_const(*this).find(key));
+    }
+
+    const JsonObject *find(const std::string_view key) const {
+        if (fields.size() < INDEX_THRESHOLD || indexed_generation != fields.generation()) {
+            for (const auto &field : fields) {
+                if (field->name == key) {
+                    return field.get();
+                }
+            }
+            return nullptr;
+        }
+        const size_t mask = index.size() - 1;
+        for (size_t slot = std::hash<std::string_view>{}(key) & mask; index[slot] != 0; slot = (slot + 1) & mask) {
+            const JsonObject *field = fields[index[slot] - 1].get();
+            if (field->name == key) {
+                return field;
+            }
+        }
+        return nullptr;
+    }
+
+    /// @function `at`
+    /// @brief Returns the first field with the given name, see `find`
+    ///
+    /// @param `key` The name of the field to find
+    /// @return `JsonObject &` The found field
+    /// @throws `std::out_of_range` If the group has no field with that name
+    JsonObject &at(const std::string_view key) {
+        return const_cast<JsonObject &>(std::as_const(*this).at(key));
+    }
+
+    const JsonObject &at(const std::string_view key) const {
+        const JsonObject *field = find(key);
+        if (field == nullptr) {
+            throw std::out_of_range("Json group '" + std::string(name) + "' has no field '" + std::string(key) + "'");
+        }
+        return *field;
+    }
+
+    /// @function `add_field`
+    /// @brief Appends the given field to the group and invalidates the lookup index
+    ///
+    /// @param `field` The field to append
+    void add_field(JsonObjectPtr field) {
+        fields.emplace_back(std::move(field));
+        invalidate_index();
+    }
+
+    /// @function `invalidate_index`
+    /// @brief Drops the lookup index, it is rebuilt by the next non-const lookup or `build_index`. Adding or removing fields through the field list is detected
+    /// automatically, this only has to be called after fields have been renamed or replaced in place
+    void invalidate_index() {
+        indexed_generation = SIZE_MAX;
+    }
 
     /// @var `fiels`
     /// @brief The fields of the group
-    std::vector<std::unique_ptr<JsonObject>> fields;
+    JsonFieldList fields;
+
+    /// @function `build_index`
+    /// @brief Builds the open-addressing lookup index over all fields unless the group is below `INDEX_THRESHOLD` or its index is
+    /// still current, the first field wins for duplicate names. Call it after changing a group which is then shared between threads
+    void build_index() {
+        if (fields.size() < INDEX_THRESHOLD || indexed_generation == fields.generation()) {
+            return;
+        }
+        size_t capacity = 1;
+        while (capacity < fields.size() * 2) {
+            capacity *= 2;
+        }
+        index.assign(capacity, 0);
+        const size_t mask = capacity - 1;
+        for (uint32_t i = 0; i < fields.size(); i++) {
+            size_t slot = std::hash<std::string_view>{}(fields[i]->name) & mask;
+            while (index[slot] != 0 && fields[index[slot] - 1]->name != fields[i]->name) {
+                slot = (slot + 1) & mask;
+            }
+            if (index[slot] == 0) {
+                index[slot] = i + 1;
+            }
+        }
+        indexed_generation = fields.generation();
+    }
+
+  private:
+    /// @var `index`
+    /// @brief The open-addressing lookup index, every slot holds a field index plus one, `0` marks an empty slot
+    std::pmr::vector<uint32_t> index;
+
+    /// @var `indexed_generation`
+    /// @brief The generation of the field list the index was built for, `SIZE_MAX` if there is no valid index
+    size_t indexed_generation = SIZE_MAX;
+
+    /// @var `destroying_parent`
+    /// @brief The group whose destructor is currently emptying this group, only set while a subtree is destroyed
+    JsonGroup *destroying_parent = nullptr;
 };
 
 /// @class `JsonString`
 /// @brief Class to represent json string values (`"...": "..."`)
 class JsonString : public JsonObject {
   public:
-    JsonString(const std::string &name, const std::string &value) :
-        name(name),
-        value(value) {}
+    static constexpr JsonObjectKind KIND = JsonObjectKind::STRING;
 
-    /// @var `name`
-    /// @brief The name of the field
-    std::string name;
+    JsonString(const std::string_view name, const std::string_view value,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+        JsonObject(KIND, name, resource),
+        value(value, resource) {}
 
     /// @var `value`
     /// @brief The value of the string field
-    std::string value;
+    std::pmr::string value;
 };
 
 /// @class `JsonNumber`
 /// @brief Class to represent json number values (`"...": 1234`)
 class JsonNumber : public JsonObject {
   public:
-    JsonNumber(const std::string &name, const int number) :
-        name(name),
-        number(number) {}
+    static constexpr JsonObjectKind KIND = JsonObjectKind::NUMBER;
 
-    /// @var `name`
-    /// @brief The name of the field
-    std::string name;
+    JsonNumber(
+        const std::string_view name,
+        const JsonNumberValue number,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+    ) :
+        JsonObject(KIND, name, resource),
+        number(number) {}
 
     /// @var `number`
     /// @brief The number value of the field
-    int number;
+    JsonNumberValue number;
 };
 
-/// @class `JsonParser`
-/// @brief Parses a given token stream of JsonTokens
-class JsonParser {
+template <typename Visitor> decltype(auto) JsonObject::visit(Visitor &&visitor) const {
+    switch (kind) {
+        case JsonObjectKind::GROUP:
+            return visitor(static_cast<const JsonGroup &>(*this));
+        case JsonObjectKind::STRING:
+            return visitor(static_cast<const JsonString &>(*this));
+        case JsonObjectKind::NUMBER:
+            break;
+    }
+    return visitor(static_cast<const JsonNumber &>(*this));
+}
+
+/// @class `JsonDomBuilder`
+/// @brief A `JsonParser::parse_events` handler which builds the object tree, either on the heap or inside a `JsonArena`
+class JsonDomBuilder {
   public:
-    JsonParser() = delete;
+    explicit JsonDomBuilder(JsonArena *arena = nullptr) :
+        arena(arena),
+        groups(arena != nullptr ? static_cast<std::pmr::memory_resource *>(arena) : std::pmr::get_default_resource()) {}
 
-    /// @function `extract_from_to`
-    /// @brief Extracts a sub-vector from the given tokens vector, beginning at `from` to mutually exlusive `to`, modifying the `tokens`
-    /// vector
+    bool on_object_begin() {
+        if (groups.empty()) {
+            if (arena == nullptr) {
+                heap_root = std::make_unique<JsonGroup>("__ROOT__");
+                root = heap_root.get();
+            } else {
+                root = new (arena->allocate(sizeof(JsonGroup), alignof(JsonGroup))) JsonGroup("__ROOT__", arena);
+                root->in_arena = true;
+            }
+            groups.emplace_back(static_cast<JsonGroup *>(root));
+            return true;
+        }
+        groups.back()->fields.emplace_back(make_node<JsonGroup>(key));
+        groups.emplace_back(static_cast<JsonGroup *>(groups.back()->fields.back().get()));
+        return true;
+    }
+
+    bool on_key(const std::string_view name) {
+        key = name;
+        return true;
+    }
+
+    bool on_string(const std::string_view value) {
+        groups.back()->fields.emplace_back(make_node<JsonString>(key, value));
+        return true;
+    }
+
+    bool on_number(const JsonNumberValue &number) {
+        groups.back()->fields.emplace_back(make_node<JsonNumber>(key, number));
+        return true;
+    }
+
+    bool on_object_end() {
+        groups.back()->build_index();
+        groups.pop_back();
+        return true;
+    }
+
+    /// @function `take_root`
+    /// @brief Hands out the built tree if it was built on the heap
     ///
-    /// @param `tokens` The tokens to extract the sub-tokens from
-    /// @param `from` The index from which to start
-    /// @param `to` The index at which to end
-    /// @return `std::vector<JsonToken>` The tokens `[from, to)`, extracted from the `tokens`
-    static std::vector<JsonToken> extract_from_to(std::vector<JsonToken> &tokens, const size_t from, const size_t to) {
-        assert(to >= from);
-        assert(to <= tokens.size());
-        std::vector<JsonToken> extraction;
-        if (to == from) {
-            return extraction;
+    /// @return `std::unique_ptr<JsonObject>` The root of the tree, `nullptr` if nothing has been built or it lives in an arena
+    std::unique_ptr<JsonObject> take_root() {
+        root = nullptr;
+        return std::move(heap_root);
+    }
+
+    /// @function `get_root`
+    /// @brief Returns the root of the built tree without taking ownership
+    ///
+    /// @return `JsonObject *` The root of the tree, `nullptr` if nothing has been built yet
+    JsonObject *get_root() const {
+        return root;
+    }
+
+  private:
+    /// @function `make_node`
+    /// @brief Creates a new node on the heap, or inside the arena if the builder has one
+    ///
+    /// @param `args` The constructor arguments of the node, without the memory resource
+    /// @return `JsonObjectPtr` The created node, nodes inside the arena are marked so their deleter leaves the memory to the arena
+    template <typename T, typename... Args> JsonObjectPtr make_node(Args &&...args) {
+        if (arena == nullptr) {
+            return std::make_unique<T>(std::forward<Args>(args)...);
         }
-        extraction.reserve(to - from);
-        std::copy(tokens.begin() + from, tokens.begin() + to, std::back_inserter(extraction));
-        tokens.erase(tokens.begin() + from, tokens.begin() + to);
-        return extraction;
+        JsonObject *node = new (arena->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)..., arena);
+        node->in_arena = true;
+        return JsonObjectPtr(node);
     }
 
+    /// @var `arena`
+    /// @brief The arena to create all nodes in, `nullptr` to create them on the heap
+    JsonArena *arena;
+
+    /// @var `heap_root`
+    /// @brief Owns the root if the tree is built on the heap
+    std::unique_ptr<JsonObject> heap_root;
+
+    /// @var `root`
+    /// @brief The root of the tree
+    JsonObject *root = nullptr;
+
+    /// @var `groups`
+    /// @brief All groups which are currently open, the innermost one last. Lives in the arena too if there is one
+    std::pmr::vector<JsonGroup *> groups;
+
+    /// @var `key`
+    /// @brief The name of the next field, pointing into the parsed buffer
+    std::string_view key;
+};
+
+/// @struct `JsonParseOptions`
+/// @brief The limits the parser enforces on its input
+struct JsonParseOptions {
+    /// @var `max_depth`
+    /// @brief The maximum number of nested groups, the root group included. Deeper input is rejected as soon as the limit is
+    /// exceeded, before any of the deeper content is looked at. A limit of `0` rejects every document with a root group, only empty
+    /// input, which has no group at all, is still accepted
+    size_t max_depth = 1024;
+};
+
+/// @class `JsonParser`
+/// @brief Parses a given token stream of JsonTokens
+class JsonParser {
+  public:
+    JsonParser() = delete;
+
     /// @function `parse`
-    /// @brief Parses the given tokens vector and retuns the JsonObject
+    /// @brief Parses the given tokens vector and retuns the JsonObject. Groups are parsed as sub-ranges of the same token list, no
+    /// tokens are ever copied. Open groups are kept on an explicit stack instead of the call stack, so the nesting depth is only
+    /// limited by `options.max_depth`
     ///
     /// @param `tokens` The tokens to parse
+    /// @param `options` The limits to parse with
     /// @return `JsonObject` The result of the parsing
-    static std::optional<std::unique_ptr<JsonObject>> parse(std::vector<JsonToken> &tokens) {
-        std::vector<std::unique_ptr<JsonObject>> objects;
-        for (size_t i = 0; i < tokens.size(); i++) {
-            if (tokens[i].type == JsonTokenType::TOK_LEFT_BRACE) {
-                i++; // Skip the {
-                size_t end_idx = i;
-                int brace_depth = 1;
-                while (end_idx < tokens.size() && brace_depth > 0) {
-                    if (tokens[end_idx].type == JsonTokenType::TOK_LEFT_BRACE) {
-                        brace_depth++;
-                    } else if (tokens[end_idx].type == JsonTokenType::TOK_RIGHT_BRACE) {
-                        brace_depth--;
-                    }
-                    end_idx++;
-                }
-                if (i >= tokens.size()) {
-                    break;
+    static std::optional<std::unique_ptr<JsonObject>> parse(const JsonTokenList &tokens, const JsonParseOptions &options = {}) {
+        // Lists whose tokens were added by hand have no brace table yet, they are indexed here without modifying the list
+        std::vector<uint32_t> own_brace_match;
+        const std::vector<uint32_t> *brace_match = &tokens.brace_match;
+        if (!tokens.has_brace_index()) {
+            if (!JsonTokenList::match_braces(tokens.tokens, own_brace_match)) {
+                JsonError::stream() << "Error: Json file contains too many tokens" << std::endl;
+                return std::nullopt;
+            }
+            brace_match = &own_brace_match;
+        }
+        std::vector<RangeFrame> stack;
+        stack.push_back(RangeFrame{std::make_unique<JsonGroup>("__ROOT__"), tokens.size(), std::nullopt});
+        size_t i = 0;
+        while (true) {
+            if (i >= stack.back().end) {
+                // The innermost range is done, hand its result to the enclosing range
+                RangeFrame frame = std::move(stack.back());
+                stack.pop_back();
+                frame.group->build_index();
+                std::unique_ptr<JsonObject> group_object = finish_range(std::move(frame.group));
+                if (stack.empty()) {
+                    return group_object;
                 }
-                std::vector<JsonToken> group_tokens = extract_from_to(tokens, i, end_idx - 1);
-                std::optional<std::unique_ptr<JsonObject>> group_object = parse(group_tokens);
-                if (!group_object.has_value()) {
-                    std::cout << "Failed to parse group object" << std::endl;
-                    return std::nullopt;
+                if (frame.name.has_value()) {
+                    group_object->name = frame.name.value();
                 }
-                objects.emplace_back(std::move(group_object.value()));
-            } else if (tokens[i].type == JsonTokenType::TOK_STR_VAL) {
+                stack.back().group->fields.emplace_back(std::move(group_object));
+                i = frame.end + 1; // Skip the }
+                continue;
+            }
+            RangeFrame &frame = stack.back();
+            std::optional<std::string_view> name;
+            if (tokens[i].type == JsonTokenType::TOK_STR_VAL) {
                 // The next token should be a colon
-                const std::string identifier = tokens[i].content;
+                const std::string_view identifier = tokens.text(tokens[i]);
                 i++;
-                if (tokens[i].type != JsonTokenType::TOK_COLON) {
-                    std::cout << "Error: expected ':' after name" << std::endl;
+                if (i >= frame.end || tokens[i].type != JsonTokenType::TOK_COLON) {
+                    JsonError::stream() << "Error: expected ':' after name" << std::endl;
                     return std::nullopt;
                 }
                 i++;
+                if (i >= frame.end) {
+                    JsonError::stream() << "Error: expected a value after ':'" << std::endl;
+                    return std::nullopt;
+                }
                 // Now it could either be: the beginning of an object, a number or a string value
                 if (tokens[i].type == JsonTokenType::TOK_NUMBER) {
-                    objects.emplace_back(std::make_unique<JsonNumber>(identifier, std::stoi(tokens[i].content)));
-                } else if (tokens[i].type == JsonTokenType::TOK_STR_VAL) {
-                    objects.emplace_back(std::make_unique<JsonString>(identifier, tokens[i].content));
-                } else if (tokens[i].type == JsonTokenType::TOK_LEFT_BRACE) {
-                    i++; // Skip the {
-                    size_t end_idx = i;
-                    int brace_depth = 1;
-                    while (end_idx < tokens.size() && brace_depth > 0) {
-                        if (tokens[end_idx].type == JsonTokenType::TOK_LEFT_BRACE) {
-                            brace_depth++;
-                        } else if (tokens[end_idx].type == JsonTokenType::TOK_RIGHT_BRACE) {
-                            brace_depth--;
-                        }
-                        end_idx++;
-                    }
-                    if (i >= tokens.size()) {
-                        break;
-                    }
-                    std::vector<JsonToken> group_tokens = extract_from_to(tokens, i, end_idx - 1);
-                    std::optional<std::unique_ptr<JsonObject>> group_object = parse(group_tokens);
-                    if (!group_object.has_value()) {
-                        std::cout << "Failed to parse group object" << std::endl;
+                    JsonNumberValue number;
+                    if (!parse_number(tokens.text(tokens[i]), number)) {
                         return std::nullopt;
                     }
-                    if (auto json_group = dynamic_cast<JsonGroup *>(group_object.value().get())) {
-                        if (json_group->name != "__ROOT__") {
-                            std::cout << "Detected double naming in json group" << std::endl;
-                            return std::nullopt;
-                        }
-                        objects.emplace_back(std::make_unique<JsonGroup>(identifier, json_group->fields));
-                    } else {
-                        objects.emplace_back(std::move(group_object.value()));
-                    }
-                } else {
-                    assert(false);
+                    frame.group->fields.emplace_back(std::make_unique<JsonNumber>(identifier, number));
+                } else if (tokens[i].type == JsonTokenType::TOK_STR_VAL) {
+                    frame.group->fields.emplace_back(std::make_unique<JsonString>(identifier, tokens.text(tokens[i])));
+                } else if (tokens[i].type != JsonTokenType::TOK_LEFT_BRACE) {
+                    JsonError::stream() << "Error: expected a value after ':'" << std::endl;
+                    return std::nullopt;
                 }
+                name = identifier;
+            }
+            if (tokens[i].type != JsonTokenType::TOK_LEFT_BRACE) {
+                i++;
+                continue;
+            }
+            i++; // Skip the {
+            if (i >= frame.end) {
+                // An unclosed group at the end of the range ends the range
+                i = frame.end;
+                continue;
             }
+            // The bottom frame is the file-level range, only the frames above it are groups
+            if (stack.size() - 1 >= options.max_depth) {
+                print_depth_error(options);
+                return std::nullopt;
+            }
+            const size_t end_idx = find_group_end(*brace_match, i, frame.end);
+            stack.push_back(RangeFrame{std::make_unique<JsonGroup>("__ROOT__"), end_idx, name});
+        }
+    }
+
+    /// @function `find_group_end`
+    /// @brief Finds the index of the `}` closing the group whose content starts at `from`, in O(1) through the brace index
+    ///
+    /// @param `brace_match` The brace table of the tokens, see `JsonTokenList::brace_match`
+    /// @param `from` The index of the first token after the opening `{`
+    /// @param `to` The index the group has to end before
+    /// @return `size_t` The index of the closing `}`, or `to` if the group is not closed
+    static size_t find_group_end(const std::vector<uint32_t> &brace_match, const size_t from, const size_t to) {
+        return std::min(static_cast<size_t>(brace_match[from - 1]), to);
+    }
+
+    /// @function `parse_buffer`
+    /// @brief Parses the given in-memory json string in a single pass, without touching the filesystem and without materializing a
+    /// token list. The tokens are pulled from the buffer while the object tree is built
+    ///
+    /// @param `json_string` The json string to parse
+    /// @param `options` The limits to parse with
+    /// @return `JsonObject` The result of the parsing
+    static std::optional<std::unique_ptr<JsonObject>> parse_buffer(const std::string_view json_string,
+        const JsonParseOptions &options = {}) {
+        JsonDomBuilder builder;
+        if (!parse_events(json_string, builder, options)) {
+            return std::nullopt;
+        }
+        return builder.take_root();
+    }
+
+    /// @function `parse_buffer`
+    /// @brief Parses the given in-memory json string in a single pass, allocating the whole tree inside the given arena
+    ///
+    /// @param `json_string` The json string to parse
+    /// @param `arena` The arena owning the resulting tree. The tree stays valid until the arena is reset or destroyed. Fields can be
+    /// removed like from a heap tree, their deleter only destroys them and leaves their memory to the arena
+    /// @param `options` The limits to parse with
+    /// @return `JsonObject *` The result of the parsing, owned by the arena
+    static std::optional<JsonObject *> parse_buffer(const std::string_view json_string, JsonArena &arena,
+        const JsonParseOptions &options = {}) {
+        JsonDomBuilder builder(&arena);
+        if (!parse_events(json_string, builder, options)) {
+            return std::nullopt;
+        }
+        return builder.get_root();
+    }
+
+    /// @function `parse_file`
+    /// @brief Parses the given json file in a single pass, see `parse_buffer`
+    ///
+    /// @param `file_path` The path the json file to parse is located at
+    /// @param `options` The limits to parse with
+    /// @return `JsonObject` The result of the parsing
+    static std::optional<std::unique_ptr<JsonObject>> parse_file(const std::filesystem::path &file_path,
+        const JsonParseOptions &options = {}) {
+        const std::shared_ptr<const JsonSource> source = JsonSource::from_file(file_path);
+        return parse_buffer(source->view(), options);
+    }
+
+    /// @function `parse_file`
+    /// @brief Parses the given json file in a single pass into the given arena, see `parse_buffer`
+    ///
+    /// @param `file_path` The path the json file to parse is located at
+    /// @param `arena` The arena owning the resulting tree
+    /// @param `options` The limits to parse with
+    /// @return `JsonObject *` The result of the parsing, owned by the arena
+    static std::optional<JsonObject *> parse_file(const std::filesystem::path &file_path, JsonArena &arena,
+        const JsonParseOptions &options = {}) {
+        const std::shared_ptr<const JsonSource> source = JsonSource::from_file(file_path);
+        return parse_buffer(source->view(), arena, options);
+    }
+
+    /// @function `parse_events`
+    /// @brief Parses the given json string in a single pass and reports its structure to the handler, without building anything and
+    /// without any heap allocation. The handler is a template parameter, so all callbacks are statically dispatched and can be
+    /// inlined. The whole document is reported as one `__ROOT__` object, an empty json string as an empty one. Groups are only
+    /// tracked by their nesting depth, the parser never recurses
+    ///
+    /// @param `json_string` The json string to parse, all views passed to the handler point into it
+    /// @param `handler` Provides `on_object_begin()`, `on_key(std::string_view)`, `on_string(std::string_view)`,
+    /// `on_number(const JsonNumberValue &)` and `on_object_end()`, every callback returns `false` to abort parsing
+    /// @param `options` The limits to parse with
+    /// @return `bool` Whether parsing succeeded, syntax errors have already been printed
+    template <typename Handler>
+    static bool parse_events(const std::string_view json_string, Handler &handler, const JsonParseOptions &options = {}) {
+        size_t pos = 0;
+        std::optional<JsonToken> token;
+        if (!JsonLexer::next_token(json_string, pos, token)) {
+            return false;
         }
-        if (objects.size() == 1) {
-            if (auto group = dynamic_cast<const JsonGroup *>(objects.at(0).get())) {
-                if (group->name == "__ROOT__") {
-                    return std::move(objects.at(0));
+        if (!token.has_value()) {
+            return handler.on_object_begin() && handler.on_object_end();
+        }
+        if (token.value().type != JsonTokenType::TOK_LEFT_BRACE) {
+            JsonError::stream() << "Error: expected '{' at the start of the json string" << std::endl;
+            return false;
+        }
+        if (options.max_depth == 0) {
+            print_depth_error(options);
+            return false;
+        }
+        if (!handler.on_object_begin()) {
+            return false;
+        }
+        // Only groups can nest, so the depth is all the state there is to keep per open group
+        size_t depth = 1;
+        bool group_start = true;
+        while (depth != 0) {
+            if (!JsonLexer::next_token(json_string, pos, token)) {
+                return false;
+            }
+            if (group_start) {
+                group_start = false;
+                if (token.has_value() && token.value().type == JsonTokenType::TOK_RIGHT_BRACE) {
+                    if (!handler.on_object_end()) {
+                        return false;
+                    }
+                    depth--;
+                    continue;
+                }
+            } else {
+                // The last field of the innermost group is done
+                if (!token.has_value()) {
+                    JsonError::stream() << "Error: expected '}' at the end of the group" << std::endl;
+                    return false;
                 }
+                if (token.value().type == JsonTokenType::TOK_RIGHT_BRACE) {
+                    if (!handler.on_object_end()) {
+                        return false;
+                    }
+                    depth--;
+                    continue;
+                }
+                if (token.value().type != JsonTokenType::TOK_COMMA) {
+                    JsonError::stream() << "Error: expected ',' or '}' after a field" << std::endl;
+                    return false;
+                }
+                if (!JsonLexer::next_token(json_string, pos, token)) {
+                    return false;
+                }
+            }
+            if (!token.has_value() || token.value().type != JsonTokenType::TOK_STR_VAL) {
+                JsonError::stream() << "Error: expected a name inside the group" << std::endl;
+                return false;
+            }
+            if (!handler.on_key(json_string.substr(token.value().offset, token.value().length))) {
+                return false;
+            }
+            if (!JsonLexer::next_token(json_string, pos, token)) {
+                return false;
+            }
+            if (!token.has_value() || token.value().type != JsonTokenType::TOK_COLON) {
+                JsonError::stream() << "Error: expected ':' after name" << std::endl;
+                return false;
+            }
+            if (!JsonLexer::next_token(json_string, pos, token)) {
+                return false;
             }
+            if (!token.has_value()) {
+                JsonError::stream() << "Error: expected a value after ':'" << std::endl;
+                return false;
+            }
+            const std::string_view content = json_string.substr(token.value().offset, token.value().length);
+            switch (token.value().type) {
+                case JsonTokenType::TOK_NUMBER: {
+                    JsonNumberValue number;
+                    if (!parse_number(content, number) || !handler.on_number(number)) {
+                        return false;
+                    }
+                    break;
+                }
+                case JsonTokenType::TOK_STR_VAL:
+                    if (!handler.on_string(content)) {
+                        return false;
+                    }
+                    break;
+                case JsonTokenType::TOK_LEFT_BRACE:
+                    if (depth >= options.max_depth) {
+                        print_depth_error(options);
+                        return false;
+                    }
+                    if (!handler.on_object_begin()) {
+                        return false;
+                    }
+                    depth++;
+                    group_start = true;
+                    break;
+                default:
+                    JsonError::stream() << "Error: expected a value after ':'" << std::endl;
+                    return false;
+            }
+        }
+        if (!JsonLexer::next_token(json_string, pos, token)) {
+            return false;
+        }
+        if (token.has_value()) {
+            JsonError::stream() << "Error: unexpected content after the root group" << std::endl;
+            return false;
         }
-        return std::make_unique<JsonGroup>("__ROOT__", objects);
+        return true;
     }
 
     /// @function `to_string`
     /// @brief Converts a given json object to a string
     ///
     /// @param `object` The object to convert
-    /// @param `indent_lvl` The indentation level of the recursive string conversion
-    /// @note Calls itself recursively
+    /// @param `indent_lvl` The indentation level the object starts at
     static std::string to_string(const JsonObject *object, int indent_lvl = 0) {
-        std::stringstream ss;
-        if (const auto group = dynamic_cast<const JsonGroup *>(object)) {
-            if (group->name != "__ROOT__") {
-                ss << std::string(indent_lvl, '\t') << "\"" << group->name << "\": ";
-            } else {
-                ss << std::string(indent_lvl, '\t');
+        JsonOutputBuffer output;
+        write(object, output, JsonFormat::PRETTY, static_cast<size_t>(indent_lvl));
+        return output.take();
+    }
+
+    /// @function `to_string`
+    /// @brief Converts a given json object to a string in the given layout
+    ///
+    /// @param `object` The object to convert
+    /// @param `format` The layout to write in
+    static std::string to_string(const JsonObject *object, const JsonFormat format) {
+        JsonOutputBuffer output;
+        write(object, output, format);
+        return output.take();
+    }
+
+    /// @function `write`
+    /// @brief Writes the given json object into the given output, in the same format as `to_string`. Open groups are kept on an
+    /// explicit stack, so the nesting depth of the tree is not limited by the call stack
+    ///
+    /// @param `object` The object to write
+    /// @param `output` The output to append to
+    /// @param `format` The layout to write in
+    /// @param `indent_lvl` The indentation level the object starts at, only used by pretty output
+    /// @return `bool` Whether the output is still good, `false` if writing to its file descriptor has failed. Text which is still
+    /// buffered is only checked by the next `flush` of the output
+    static bool write(const JsonObject *object, JsonOutputBuffer &output, const JsonFormat format = JsonFormat::PRETTY,
+        const size_t indent_lvl = 0) {
+        const auto group = object->as<JsonGroup>();
+        if (group == nullptr) {
+            write_field(object, output, format, indent_lvl);
+            return output.good();
+        }
+        std::vector<WriteFrame> stack;
+        write_group_begin(group, output, format, indent_lvl);
+        stack.push_back(WriteFrame{group, 0});
+        while (!stack.empty()) {
+            WriteFrame &frame = stack.back();
+            const size_t level = indent_lvl + stack.size() - 1;
+            if (frame.next_field == frame.group->fields.size()) {
+                output.write_group_close(format, level, !frame.group->fields.empty());
+                stack.pop_back();
+                continue;
             }
-            ss << "{\n";
-            for (auto it = group->fields.begin(); it != group->fields.end(); ++it) {
-                if (it != group->fields.begin()) {
-                    ss << ",\n";
-                }
-                ss << to_string((*it).get(), indent_lvl + 1);
-                if (it == std::prev(group->fields.end())) {
-                    ss << "\n";
-                }
+            if (frame.next_field != 0) {
+                output.write_separator(format);
+            }
+            const JsonObject *field = frame.group->fields[frame.next_field++].get();
+            if (const auto nested = field->as<JsonGroup>()) {
+                write_group_begin(nested, output, format, level + 1);
+                stack.push_back(WriteFrame{nested, 0});
+            } else {
+                write_field(field, output, format, level + 1);
             }
-            ss << std::string(indent_lvl, '\t') << "}";
-        } else if (const auto string = dynamic_cast<const JsonString *>(object)) {
-            ss << std::string(indent_lvl, '\t') << "\"" << string->name << "\": " << "\"" << string->value << "\"";
-        } else if (const auto number = dynamic_cast<const JsonNumber *>(object)) {
-            ss << std::string(indent_lvl, '\t') << "\"" << number->name << "\": " << number->number;
         }
-        return ss.str();
+        return output.good();
     }
 
     /// @function `print_json_object`
     /// @brief Prints a given json object to the console
     ///
     /// @param `object` The object to print
-    static void print_json_object(const JsonObject *object) {
-        std::cout << to_string(object) << std::endl;
+    /// @param `format` The layout to print in
+    static void print_json_object(const JsonObject *object, const JsonFormat format = JsonFormat::PRETTY) {
+        JsonOutputBuffer output;
+        write(object, output, format);
+        output.append('\n');
+        std::cout << output.view() << std::flush;
+    }
+
+  private:
+    /// @struct `WriteFrame`
+    /// @brief A group which `write` is currently writing the fields of
+    struct WriteFrame {
+        /// @var `group`
+        /// @brief The group being written
+        const JsonGroup *group;
+
+        /// @var `next_field`
+        /// @brief The index of the next field of the group to write
+        size_t next_field;
+    };
+
+    /// @function `write_group_begin`
+    /// @brief Writes the name and the opening `{` of the given group, groups named `__ROOT__` are written without a name
+    static void write_group_begin(const JsonGroup *group, JsonOutputBuffer &output, const JsonFormat format, const size_t level) {
+        if (group->name != "__ROOT__") {
+            output.write_name(format, level, group->name);
+        } else {
+            output.write_indent(format, level);
+        }
+        output.write_group_open(format);
+    }
+
+    /// @function `write_field`
+    /// @brief Writes the given string or number field
+    static void write_field(const JsonObject *object, JsonOutputBuffer &output, const JsonFormat format, const size_t level) {
+        output.write_name(format, level, object->name);
+        if (const auto string = object->as<JsonString>()) {
+            output.write_string(string->value);
+        } else {
+            output.append_number(static_cast<const JsonNumber *>(object)->number);
+        }
+    }
+
+    /// @struct `RangeFrame`
+    /// @brief A token range of `parse` which is still being parsed
+    struct RangeFrame {
+        /// @var `group`
+        /// @brief Collects the objects parsed from the range so far
+        std::unique_ptr<JsonGroup> group;
+
+        /// @var `end`
+        /// @brief The index the range ends at, the index of its closing `}` for nested groups
+        size_t end;
+
+        /// @var `name`
+        /// @brief The name the resulting group gets in the enclosing range, pointing into the token source, `std::nullopt` for
+        /// groups without a name
+        std::optional<std::string_view> name;
+    };
+
+    /// @function `finish_range`
+    /// @brief Turns the objects parsed from a range into the result of the range. A range which only consists of a single unnamed
+    /// group results in that group
+    ///
+    /// @param `group` The `__ROOT__` group holding the objects of the range
+    /// @return `std::unique_ptr<JsonObject>` The result of the range
+    static std::unique_ptr<JsonObject> finish_range(std::unique_ptr<JsonGroup> group) {
+        if (group->fields.size() == 1) {
+            if (auto nested = group->fields.at(0)->as<JsonGroup>()) {
+                if (nested->name == "__ROOT__") {
+                    // The tree of `parse` is always on the heap, so the field can be handed out with the default deleter
+                    return std::unique_ptr<JsonObject>(group->fields.at(0).release());
+                }
+            }
+        }
+        return group;
+    }
+
+    /// @function `parse_number`
+    /// @brief Converts the content of a number token, reporting numbers which do not fit into a `double`
+    ///
+    /// @param `content` The text of the number token
+    /// @param `number` Set to the parsed number
+    /// @return `bool` Whether the number could be converted
+    static bool parse_number(const std::string_view content, JsonNumberValue &number) {
+        if (!JsonNumberValue::parse(content, number)) {
+            JsonError::stream() << "Error: Number is out of range: '" << content << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /// @function `print_depth_error`
+    /// @brief Reports input which is nested deeper than allowed
+    static void print_depth_error(const JsonParseOptions &options) {
+        JsonError::stream() << "Error: Json nesting depth exceeds the maximum of " << options.max_depth << std::endl;
     }
 };
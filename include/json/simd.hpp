@@ -0,0 +1,240 @@
+#pragma once
+
+#include "bits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_MINI_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define JSON_MINI_X86_SIMD 0
+#endif
+
+/// @struct `JsonBlockMasks`
+/// @brief The classification of one block of json input, bit `i` of every mask describes byte `i` of the block
+struct JsonBlockMasks {
+    /// @var `quote`
+    /// @brief All `"` characters
+    uint64_t quote;
+
+    /// @var `structural`
+    /// @brief All `{`, `}`, `:` and `,` characters
+    uint64_t structural;
+
+    /// @var `whitespace`
+    /// @brief All ` `, `\t`, `\n` and `\r` characters
+    uint64_t whitespace;
+
+    /// @var `number`
+    /// @brief All characters which can be part of a number: ASCII digits, `-`, `+`, `.`, `e` and `E`
+    uint64_t number;
+};
+
+/// @class `JsonSimd`
+/// @brief Vectorized classification kernels for the first lexing stage. Every kernel classifies one block of `BLOCK_SIZE` bytes into
+/// bitmasks, the lexer then emits the tokens from these bitmasks. Targets without a kernel fall back to the scalar lexer
+class JsonSimd {
+  public:
+    JsonSimd() = delete;
+
+    /// @var `BLOCK_SIZE`
+    /// @brief The number of bytes every classification kernel processes at once
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    /// @var `AVX2_PROBE_SIZE`
+    /// @brief The number of bytes `find_quote` searches with the SSE2 kernel before it switches to the AVX2 kernel
+    static constexpr size_t AVX2_PROBE_SIZE = 256;
+
+#if JSON_MINI_X86_SIMD
+    /// @function `classify_sse2`
+    /// @brief Classifies the given block 16 bytes at a time, SSE2 is the baseline of every x86-64 cpu
+    ///
+    /// @param `block` The block to classify, has to be `BLOCK_SIZE` bytes long
+    /// @return `JsonBlockMasks` The classification of the block
+    static JsonBlockMasks classify_sse2(const char *block) {
+        JsonBlockMasks masks{0, 0, 0, 0};
+        for (size_t i = 0; i < BLOCK_SIZE; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+            const __m128i quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+            const __m128i structural = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')))
+            );
+            const __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')))
+            );
+            // Signed compares, bytes >= 0x80 are negative and therefore never digits
+            const __m128i digit = _mm_and_si128(
+                _mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1))
+            );
+            // Setting the 0x20 bit maps `E` onto `e` and no other byte onto it
+            const __m128i number = _mm_or_si128(
+                _mm_or_si128(digit, _mm_cmpeq_epi8(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), _mm_set1_epi8('e'))),
+                _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('-')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('+'))),
+                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8('.'))
+                )
+            );
+            masks.quote |= uint64_t(uint16_t(_mm_movemask_epi8(quote))) << i;
+            masks.structural |= uint64_t(uint16_t(_mm_movemask_epi8(structural))) << i;
+            masks.whitespace |= uint64_t(uint16_t(_mm_movemask_epi8(whitespace))) << i;
+            masks.number |= uint64_t(uint16_t(_mm_movemask_epi8(number))) << i;
+        }
+        return masks;
+    }
+
+    /// @function `classify_avx2`
+    /// @brief Classifies the given block 32 bytes at a time, only call this if `has_avx2` returns true
+    ///
+    /// @param `block` The block to classify, has to be `BLOCK_SIZE` bytes long
+    /// @return `JsonBlockMasks` The classification of the block
+    __attribute__((target("avx2"))) static JsonBlockMasks classify_avx2(const char *block) {
+        JsonBlockMasks masks{0, 0, 0, 0};
+        for (size_t i = 0; i < BLOCK_SIZE; i += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+            const __m256i quote = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+            const __m256i structural = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')))
+            );
+            const __m256i whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')))
+            );
+            // Signed compares, bytes >= 0x80 are negative and therefore never digits
+            const __m256i digit = _mm256_andnot_si256(
+                _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('9')), _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('0' - 1))
+            );
+            // Setting the 0x20 bit maps `E` onto `e` and no other byte onto it
+            const __m256i number = _mm256_or_si256(
+                _mm256_or_si256(digit, _mm256_cmpeq_epi8(_mm256_or_si256(chunk, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('e'))),
+                _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('-')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('+'))),
+                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('.'))
+                )
+            );
+            masks.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(quote))) << i;
+            masks.structural |= uint64_t(uint32_t(_mm256_movemask_epi8(structural))) << i;
+            masks.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(whitespace))) << i;
+            masks.number |= uint64_t(uint32_t(_mm256_movemask_epi8(number))) << i;
+        }
+        return masks;
+    }
+
+    /// @function `find_quote_sse2`
+    /// @brief Returns the position of the first `"` in `[pos, length)`, searching 16 bytes at a time
+    ///
+    /// @param `data` The buffer to search in
+    /// @param `pos` The position to start searching at
+    /// @param `length` The length of the buffer
+    /// @return `size_t` The position of the first quote, `length` if there is none
+    static size_t find_quote_sse2(const char *data, size_t pos, const size_t length) {
+        const __m128i quote = _mm_set1_epi8('"');
+        for (; pos + 16 <= length; pos += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+            const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote));
+            if (mask != 0) {
+                return pos + JsonBits::count_trailing_zeros(static_cast<unsigned int>(mask));
+            }
+        }
+        return find_quote_tail(data, pos, length);
+    }
+
+    /// @function `find_quote_avx2`
+    /// @brief Returns the position of the first `"` in `[pos, length)`, searching 64 bytes at a time. Only call this if `has_avx2`
+    /// returns true
+    ///
+    /// @param `data` The buffer to search in
+    /// @param `pos` The position to start searching at
+    /// @param `length` The length of the buffer
+    /// @return `size_t` The position of the first quote, `length` if there is none
+    __attribute__((target("avx2"))) static size_t find_quote_avx2(const char *data, size_t pos, const size_t length) {
+        const __m256i quote = _mm256_set1_epi8('"');
+        for (; pos + 64 <= length; pos += 64) {
+            const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos + 32));
+            const uint64_t mask = uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quote)))) |
+                uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quote)))) << 32;
+            if (mask != 0) {
+                return pos + JsonBits::count_trailing_zeros(mask);
+            }
+        }
+        if (pos + 32 <= length) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+            const uint32_t mask = uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)));
+            if (mask != 0) {
+                return pos + JsonBits::count_trailing_zeros(mask);
+            }
+            pos += 32;
+        }
+        return find_quote_sse2(data, pos, length);
+    }
+
+    /// @function `has_avx2`
+    /// @brief Returns whether the cpu the program is running on supports AVX2
+    ///
+    /// @return `bool` Whether `classify_avx2` may be called
+    static bool has_avx2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#endif
+
+    /// @function `find_quote`
+    /// @brief Returns the position of the first `"` in `[pos, length)` using the widest kernel the cpu supports. Most keys and
+    /// values are short, so the first `AVX2_PROBE_SIZE` bytes are always searched by the SSE2 kernel, which is inlined into the
+    /// caller. Only longer bodies pay for the call into the AVX2 kernel
+    ///
+    /// @param `data` The buffer to search in
+    /// @param `pos` The position to start searching at
+    /// @param `length` The length of the buffer
+    /// @return `size_t` The position of the first quote, `length` if there is none
+    static size_t find_quote(const char *data, const size_t pos, const size_t length) {
+#if JSON_MINI_X86_SIMD
+        if (!has_avx2()) {
+            return find_quote_sse2(data, pos, length);
+        }
+        const size_t probe_end = length - pos > AVX2_PROBE_SIZE ? pos + AVX2_PROBE_SIZE : length;
+        const size_t probe_result = find_quote_sse2(data, pos, probe_end);
+        if (probe_result != probe_end || probe_end == length) {
+            return probe_result;
+        }
+        return find_quote_avx2(data, probe_end, length);
+#else
+        return find_quote_tail(data, pos, length);
+#endif
+    }
+
+    /// @function `find_quote_tail`
+    /// @brief Returns the position of the first `"` in `[pos, length)`, searching one byte at a time
+    ///
+    /// @param `data` The buffer to search in
+    /// @param `pos` The position to start searching at
+    /// @param `length` The length of the buffer
+    /// @return `size_t` The position of the first quote, `length` if there is none
+    static size_t find_quote_tail(const char *data, size_t pos, const size_t length) {
+        while (pos != length && data[pos] != '"') {
+            pos++;
+        }
+        return pos;
+    }
+
+    /// @function `prefix_xor`
+    /// @brief Computes the running xor of all bits, bit `i` of the result is the xor of the bits `0..i` of the input. Applied to the
+    /// quote mask this yields every byte which lies inside a string, including the opening quote but excluding the closing quote
+    ///
+    /// @param `bits` The bits to compute the prefix xor of
+    /// @return `uint64_t` The prefix xor of the bits
+    static uint64_t prefix_xor(uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifndef JSON_MINI_POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#define JSON_MINI_POSIX 1
+#else
+#define JSON_MINI_POSIX 0
+#endif
+#endif
+
+#if JSON_MINI_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// @class `JsonSource`
+/// @brief Owns the raw bytes of a json document. Regular files are memory-mapped, everything else (pipes, fifos, character devices)
+/// is read into an owned buffer through `read()`. Targets without POSIX read every file through `std::ifstream`. In-memory buffers are borrowed without copying them. Sources are always handed out
+/// as `std::shared_ptr`, so the mapping stays alive for as long as anything still references its bytes
+class JsonSource {
+  public:
+    JsonSource(const JsonSource &) = delete;
+    JsonSource &operator=(const JsonSource &) = delete;
+
+    ~JsonSource() {
+#if JSON_MINI_POSIX
+        if (mapping != nullptr) {
+            munmap(mapping, mapping_size);
+        }
+#endif
+    }
+
+    /// @function `from_file`
+    /// @brief Opens the given file and makes its bytes available without copying them, if possible
+    ///
+    /// @param `file_path` The path of the file to load
+    /// @return `std::shared_ptr<const JsonSource>` The loaded source
+    /// @throws `std::runtime_error` If the file could not be opened, mapped or read
+    static std::shared_ptr<const JsonSource> from_file(const std::filesystem::path &file_path) {
+#if JSON_MINI_POSIX
+        const int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+        std::shared_ptr<JsonSource> source(new JsonSource());
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+            source->map_file(fd, static_cast<size_t>(file_stat.st_size));
+        }
+        if (source->mapping == nullptr && !read_all(fd, source->buffer)) {
+            close(fd);
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+        close(fd);
+        return source;
+#else
+        std::shared_ptr<JsonSource> source(new JsonSource());
+        read_file(file_path, source->buffer);
+        return source;
+#endif
+    }
+
+    /// @function `from_view`
+    /// @brief Wraps an in-memory buffer without copying it
+    ///
+    /// @param `bytes` The buffer to wrap, the caller has to keep it alive for as long as the source is referenced
+    /// @return `std::shared_ptr<const JsonSource>` The source borrowing the buffer
+    static std::shared_ptr<const JsonSource> from_view(const std::string_view bytes) {
+        std::shared_ptr<JsonSource> source(new JsonSource());
+        source->borrowed = bytes;
+        return source;
+    }
+
+    /// @function `view`
+    /// @brief Returns a view over all bytes of the source
+    ///
+    /// @return `std::string_view` The bytes of the source, valid for the lifetime of this source
+    std::string_view view() const {
+        if (mapping != nullptr) {
+            return std::string_view(static_cast<const char *>(mapping), mapping_size);
+        }
+        if (borrowed.data() != nullptr) {
+            return borrowed;
+        }
+        return std::string_view(buffer);
+    }
+
+    /// @function `read_file`
+    /// @brief Reads the whole given file into the given buffer without mapping it, for callers which reuse one buffer across many
+    /// small files
+    ///
+    /// @param `file_path` The path of the file to read
+    /// @param `buffer` The buffer to replace with the bytes of the file, its capacity is reused
+    /// @throws `std::runtime_error` If the file could not be opened or read
+    static void read_file(const std::filesystem::path &file_path, std::string &buffer) {
+#if JSON_MINI_POSIX
+        const int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+        buffer.clear();
+        const bool success = read_all(fd, buffer);
+        close(fd);
+#else
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+        buffer.clear();
+        char chunk[65536];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+            buffer.append(chunk, static_cast<size_t>(file.gcount()));
+        }
+        const bool success = !file.bad();
+#endif
+        if (!success) {
+            throw std::runtime_error("Failed to load file " + file_path.string());
+        }
+    }
+
+#if JSON_MINI_POSIX
+
+    /// @function `read_all`
+    /// @brief Reads everything from the given file descriptor and appends it to the given buffer, used for pipes and other
+    /// unmappable files
+    ///
+    /// @param `fd` The file descriptor to read from
+    /// @param `buffer` The buffer to append the read bytes to, its capacity is reused
+    /// @return `bool` Whether reading succeeded
+    static bool read_all(const int fd, std::string &buffer) {
+        char chunk[65536];
+        while (true) {
+            const ssize_t bytes_read = read(fd, chunk, sizeof(chunk));
+            if (bytes_read < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (bytes_read == 0) {
+                return true;
+            }
+            buffer.append(chunk, static_cast<size_t>(bytes_read));
+        }
+    }
+#endif
+
+  private:
+    JsonSource() = default;
+
+#if JSON_MINI_POSIX
+    /// @function `map_file`
+    /// @brief Maps the whole file read-only into memory, leaves `mapping` empty if mapping is not possible (empty files for example)
+    ///
+    /// @param `fd` The file descriptor of the regular file to map
+    /// @param `size` The size of the file in bytes
+    void map_file(const int fd, const size_t size) {
+        if (size == 0) {
+            return;
+        }
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            return;
+        }
+        madvise(addr, size, MADV_SEQUENTIAL);
+        mapping = addr;
+        mapping_size = size;
+    }
+#endif
+
+    /// @var `mapping`
+    /// @brief The start of the memory mapping, `nullptr` if the source is not mapped
+    void *mapping = nullptr;
+
+    /// @var `mapping_size`
+    /// @brief The size of the memory mapping in bytes
+    size_t mapping_size = 0;
+
+    /// @var `buffer`
+    /// @brief The owned bytes of the source if it could not be mapped
+    std::string buffer;
+
+    /// @var `borrowed`
+    /// @brief The borrowed bytes of an in-memory source, not owned by the source
+    std::string_view borrowed;
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "error.hpp"
+#include "lexer.hpp"
+#include "simd.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+/// @class `JsonStreamLexer`
+/// @brief A push-based lexer for json input which arrives in chunks, for example through a pipe. Tokens are emitted as soon as they
+/// are complete, only a string or number which is cut by a chunk boundary is buffered, so memory stays bounded by the largest
+/// single token. Feeding all chunks and calling `finish` produces the same tokens as `JsonLexer::scan` on the concatenated input
+class JsonStreamLexer {
+  public:
+    JsonStreamLexer() = default;
+
+    /// @function `feed`
+    /// @brief Lexes the next chunk of the input and emits every token which is completed by it
+    ///
+    /// @param `chunk` The next chunk of the input, it does not need to outlive this call
+    /// @param `emit` Called as `emit(const JsonToken &token, std::string_view content)` for every completed token. The token offset
+    /// is the offset within the whole stream, the content view is only valid during the call
+    /// @return `bool` Whether lexing succeeded, the error has already been printed if it did not
+    template <typename Emit> bool feed(const std::string_view chunk, Emit &&emit) {
+        if (state == State::FAILED) {
+            return false;
+        }
+        size_t pos = 0;
+        if (state == State::IN_STRING) {
+            pos = JsonSimd::find_quote(chunk.data(), 0, chunk.length());
+            partial.append(chunk.data(), pos);
+            if (pos == chunk.length()) {
+                consumed += chunk.length();
+                return true;
+            }
+            if (!emit_partial(JsonTokenType::TOK_STR_VAL, emit)) {
+                return false;
+            }
+            pos++; // Skip the closing "
+        } else if (state == State::IN_NUMBER) {
+            while (pos != chunk.length() && JsonLexer::is_number_char(chunk[pos])) {
+                pos++;
+            }
+            partial.append(chunk.data(), pos);
+            if (pos == chunk.length()) {
+                consumed += chunk.length();
+                return true;
+            }
+            if (!emit_partial(JsonTokenType::TOK_NUMBER, emit)) {
+                return false;
+            }
+        }
+
+        for (size_t end = pos; end < chunk.length(); end++) {
+            switch (chunk[end]) {
+                default:
+                    if (JsonLexer::is_number_char(chunk[end])) {
+                        const size_t start = end;
+                        end++;
+                        while (end != chunk.length() && JsonLexer::is_number_char(chunk[end])) {
+                            end++;
+                        }
+                        if (end == chunk.length()) {
+                            begin_partial(State::IN_NUMBER, chunk, start);
+                            return true;
+                        }
+                        if (!JsonLexer::check_number(chunk.substr(start, end - start))) {
+                            state = State::FAILED;
+                            return false;
+                        }
+                        emit(JsonToken(JsonTokenType::TOK_NUMBER, consumed + start, static_cast<uint32_t>(end - start)),
+                            chunk.substr(start, end - start));
+                        // The character after the number has not been lexed yet
+                        end--;
+                        break;
+                    }
+                    JsonError::stream() << "Error: Unknown character in json string: '" << chunk[end] << "'" << std::endl;
+                    state = State::FAILED;
+                    return false;
+                case '\n':
+                    [[fallthrough]];
+                case '\t':
+                    [[fallthrough]];
+                case '\r':
+                    [[fallthrough]];
+                case ' ':
+                    break;
+                case '{':
+                    emit(JsonToken(JsonTokenType::TOK_LEFT_BRACE, consumed + end, 1), chunk.substr(end, 1));
+                    break;
+                case '}':
+                    emit(JsonToken(JsonTokenType::TOK_RIGHT_BRACE, consumed + end, 1), chunk.substr(end, 1));
+                    break;
+                case ':':
+                    emit(JsonToken(JsonTokenType::TOK_COLON, consumed + end, 1), chunk.substr(end, 1));
+                    break;
+                case ',':
+                    emit(JsonToken(JsonTokenType::TOK_COMMA, consumed + end, 1), chunk.substr(end, 1));
+                    break;
+                case '"': {
+                    const size_t start = end + 1;
+                    end = JsonSimd::find_quote(chunk.data(), start, chunk.length());
+                    if (end == chunk.length()) {
+                        begin_partial(State::IN_STRING, chunk, start);
+                        return true;
+                    }
+                    if (end - start > UINT32_MAX) {
+                        JsonError::stream() << "Error: String value exceeds the maximum token length" << std::endl;
+                        state = State::FAILED;
+                        return false;
+                    }
+                    emit(JsonToken(JsonTokenType::TOK_STR_VAL, consumed + start, static_cast<uint32_t>(end - start)),
+                        chunk.substr(start, end - start));
+                    break;
+                }
+            }
+        }
+        consumed += chunk.length();
+        return true;
+    }
+
+    /// @function `finish`
+    /// @brief Signals the end of the input. Reports a string or number which is still open as an error and resets the lexer, so it
+    /// can be used for the next stream
+    ///
+    /// @return `bool` Whether the whole stream was lexed successfully, the error has already been printed if it was not
+    bool finish() {
+        const State end_state = state;
+        reset();
+        switch (end_state) {
+            case State::IDLE:
+                return true;
+            case State::IN_STRING:
+                JsonError::stream() << "Error: Unterminated string value at the end of the json string" << std::endl;
+                return false;
+            case State::IN_NUMBER:
+                JsonError::stream() << "Error: Json file ended with a number, not with a '}'" << std::endl;
+                return false;
+            case State::FAILED:
+                return false;
+        }
+        return false;
+    }
+
+    /// @function `reset`
+    /// @brief Discards all partial state, the buffered capacity is kept for the next stream
+    void reset() {
+        state = State::IDLE;
+        partial.clear();
+        partial_offset = 0;
+        consumed = 0;
+    }
+
+  private:
+    /// @enum `State`
+    /// @brief Where the lexer stopped at the end of the last chunk
+    enum class State : uint8_t {
+        IDLE,
+        IN_STRING,
+        IN_NUMBER,
+        FAILED,
+    };
+
+    /// @function `begin_partial`
+    /// @brief Buffers the token which is cut by the end of the given chunk
+    ///
+    /// @param `new_state` The kind of token which is cut
+    /// @param `chunk` The current chunk
+    /// @param `start` The position within the chunk at which the content of the token starts
+    void begin_partial(const State new_state, const std::string_view chunk, const size_t start) {
+        state = new_state;
+        partial.assign(chunk.data() + start, chunk.length() - start);
+        partial_offset = consumed + start;
+        consumed += chunk.length();
+    }
+
+    /// @function `emit_partial`
+    /// @brief Emits the buffered token once its end has been found
+    ///
+    /// @param `type` The type of the buffered token
+    /// @param `emit` The token callback
+    /// @return `bool` Whether the token could be emitted
+    template <typename Emit> bool emit_partial(const JsonTokenType type, Emit &emit) {
+        if (partial.length() > UINT32_MAX) {
+            JsonError::stream() << "Error: String value exceeds the maximum token length" << std::endl;
+            state = State::FAILED;
+            return false;
+        }
+        if (type == JsonTokenType::TOK_NUMBER && !JsonLexer::check_number(partial)) {
+            state = State::FAILED;
+            return false;
+        }
+        emit(JsonToken(type, partial_offset, static_cast<uint32_t>(partial.length())), std::string_view(partial));
+        state = State::IDLE;
+        partial.clear();
+        return true;
+    }
+
+    /// @var `state`
+    /// @brief Where the lexer stopped at the end of the last chunk
+    State state = State::IDLE;
+
+    /// @var `partial`
+    /// @brief The content of the token which is cut by the end of the last chunk
+    std::string partial;
+
+    /// @var `partial_offset`
+    /// @brief The stream offset at which the content of the partial token starts
+    uint64_t partial_offset = 0;
+
+    /// @var `consumed`
+    /// @brief The number of bytes of the stream which have been fed so far, the stream offset of the next chunk
+    uint64_t consumed = 0;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "output.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @class `JsonWriter`
+/// @brief Writes json text field by field straight into a `JsonOutputBuffer`, without building an object tree first. The output
+/// has the same layout as `JsonParser::write` produces for the equivalent tree. Open objects are tracked on a stack of one bit per
+/// object, which is reserved up front for the default depth limit, so writing such documents never allocates beyond the growth of
+/// the output buffer itself
+class JsonWriter {
+  public:
+    /// @var `DEFAULT_MAX_DEPTH`
+    /// @brief The default maximum number of nested objects, the root object included. It is the default of
+    /// `JsonParseOptions::max_depth`, so the writer accepts every document the parser accepts
+    static constexpr size_t DEFAULT_MAX_DEPTH = 1024;
+
+    /// @param `output` The output to write to, has to outlive the writer
+    /// @param `format` The layout to write in
+    /// @param `max_depth` The maximum number of nested objects, the root object included
+    explicit JsonWriter(JsonOutputBuffer &output, const JsonFormat format = JsonFormat::PRETTY,
+        const size_t max_depth = DEFAULT_MAX_DEPTH) :
+        output(output),
+        format(format),
+        max_depth(max_depth) {
+        has_fields.reserve(std::min(max_depth, DEFAULT_MAX_DEPTH));
+    }
+
+    /// @function `begin_object`
+    /// @brief Opens the root object of the document
+    ///
+    /// @throws `std::logic_error` If the root object has already been opened
+    /// @throws `std::length_error` If the depth limit is `0`
+    void begin_object() {
+        if (!has_fields.empty() || root_written) {
+            throw std::logic_error("Json writer can only write a single root object");
+        }
+        if (max_depth == 0) {
+            throw std::length_error("Json writer nesting depth exceeds the maximum of 0");
+        }
+        output.write_indent(format, 0);
+        output.write_group_open(format);
+        push();
+        root_written = true;
+    }
+
+    /// @function `begin_object`
+    /// @brief Opens a nested object as the next field of the current object
+    ///
+    /// @param `key` The name of the object
+    /// @throws `std::logic_error` If no object is open
+    /// @throws `std::length_error` If the object would be nested deeper than the depth limit
+    void begin_object(const std::string_view key) {
+        if (has_fields.size() >= max_depth) {
+            throw std::length_error("Json writer nesting depth exceeds the maximum of " + std::to_string(max_depth));
+        }
+        begin_field(key);
+        output.write_group_open(format);
+        push();
+    }
+
+    /// @function `add_string`
+    /// @brief Writes a string field into the current object, the value is written as is
+    ///
+    /// @param `key` The name of the field
+    /// @param `value` The value of the field
+    /// @throws `std::logic_error` If no object is open
+    void add_string(const std::string_view key, const std::string_view value) {
+        begin_field(key);
+        output.write_string(value);
+    }
+
+    /// @function `add_number`
+    /// @brief Writes a number field into the current object. NaN and infinite doubles never get here, converting them to a
+    /// `JsonNumberValue` already throws `std::invalid_argument`
+    ///
+    /// @param `key` The name of the field
+    /// @param `number` The value of the field
+    /// @throws `std::logic_error` If no object is open
+    void add_number(const std::string_view key, const JsonNumberValue &number) {
+        begin_field(key);
+        output.append_number(number);
+    }
+
+    /// @function `end_object`
+    /// @brief Closes the current object
+    ///
+    /// @throws `std::logic_error` If no object is open
+    void end_object() {
+        if (has_fields.empty()) {
+            throw std::logic_error("Json writer has no open object to end");
+        }
+        const bool had_fields = has_fields.back();
+        has_fields.pop_back();
+        output.write_group_close(format, has_fields.size(), had_fields);
+    }
+
+    /// @function `is_complete`
+    /// @brief Returns whether the root object has been written and closed
+    bool is_complete() const {
+        return root_written && has_fields.empty();
+    }
+
+    /// @function `reset`
+    /// @brief Allows writing the next document into the same output, the current one has to be complete
+    ///
+    /// @throws `std::logic_error` If there is still an open object
+    void reset() {
+        if (!has_fields.empty()) {
+            throw std::logic_error("Json writer can not be reset while an object is open");
+        }
+        root_written = false;
+    }
+
+  private:
+    /// @function `begin_field`
+    /// @brief Writes the separator to the previous field and the name of the next field of the current object
+    void begin_field(const std::string_view key) {
+        if (has_fields.empty()) {
+            throw std::logic_error("Json writer has no open object to write a field into");
+        }
+        if (has_fields.back()) {
+            output.write_separator(format);
+        }
+        has_fields.back() = true;
+        output.write_name(format, has_fields.size(), key);
+    }
+
+    /// @function `push`
+    /// @brief Pushes a new, still empty object onto the stack of open objects
+    void push() {
+        has_fields.push_back(false);
+    }
+
+    /// @var `output`
+    /// @brief The output all text is written to
+    JsonOutputBuffer &output;
+
+    /// @var `format`
+    /// @brief The layout the text is written in
+    JsonFormat format;
+
+    /// @var `max_depth`
+    /// @brief The maximum number of nested objects, the root object included
+    size_t max_depth;
+
+    /// @var `has_fields`
+    /// @brief For every open object whether a field has already been written into it, its size is the number of open objects
+    std::vector<bool> has_fields;
+
+    /// @var `root_written`
+    /// @brief Whether the root object of the current document has been opened
+    bool root_written = false;
+};
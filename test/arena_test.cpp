@@ -0,0 +1,39 @@
+#include "check.hpp"
+
+#include <json/arena.hpp>
+#include <json/parser.hpp>
+
+#include <memory>
+#include <string>
+
+/// Fields of arena trees can be removed with the ordinary container operations, without deleting arena memory
+int main() {
+    const std::string json = "{\"a\": 1, \"b\": \"two\", \"c\": {\"d\": {\"e\": 5}, \"f\": 6}, \"g\": 7, \"h\": {}}";
+    JsonArena arena;
+    const std::optional<JsonObject *> root = JsonParser::parse_buffer(json, arena);
+    CHECK(root.has_value());
+    CHECK(root.value()->is_in_arena());
+    JsonGroup *group = root.value()->as<JsonGroup>();
+    CHECK(group->fields.size() == 5);
+    CHECK(group->find("a")->is_in_arena());
+
+    group->fields.pop_back();
+    group->fields.erase(group->fields.begin());
+    CHECK(group->fields.size() == 3);
+    CHECK(group->find("a") == nullptr);
+
+    // Heap fields can be mixed into an arena tree, they are deleted as usual
+    group->add_field(std::make_unique<JsonString>("heap", "value"));
+    CHECK(!group->find("heap")->is_in_arena());
+    group->find("c")->as<JsonGroup>()->fields.clear();
+    CHECK(JsonParser::to_string(group, JsonFormat::COMPACT) == "{\"b\":\"two\",\"c\":{},\"g\":7,\"heap\":\"value\"}");
+    group->fields.clear();
+    CHECK(group->fields.empty());
+
+    // Heap trees still own and delete their fields
+    std::optional<std::unique_ptr<JsonObject>> heap_root = JsonParser::parse_buffer(json);
+    CHECK(heap_root.has_value());
+    CHECK(!heap_root.value()->is_in_arena());
+    heap_root.value()->as<JsonGroup>()->fields.erase(heap_root.value()->as<JsonGroup>()->fields.begin());
+    return check_result("arena_test");
+}
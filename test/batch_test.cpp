@@ -0,0 +1,64 @@
+#include "check.hpp"
+
+#include <json/batch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// The parse errors of a batch end up in the result of the file they belong to, nothing is printed
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "json_batch_test";
+    std::filesystem::create_directories(directory);
+    std::vector<std::filesystem::path> paths;
+    for (size_t i = 0; i < 64; i++) {
+        paths.emplace_back(directory / ("file" + std::to_string(i) + ".json"));
+        std::ofstream file(paths.back());
+        if (i % 4 == 1) {
+            file << "{\"id\": " << i << ", \"bad\": ?}";
+        } else if (i % 4 == 3) {
+            file << "{\"id\": " << i << ", \"deep\": {\"deeper\": {}}}";
+        } else {
+            file << "{\"id\": " << i << "}";
+        }
+    }
+    paths.emplace_back(directory / "missing.json");
+
+    JsonParseOptions options;
+    options.max_depth = 2;
+    std::ostringstream printed;
+    std::streambuf *const cout_buffer = std::cout.rdbuf(printed.rdbuf());
+    const std::vector<JsonFileResult> results = JsonBatchParser::parse_files(paths, 4, options);
+    std::cout.rdbuf(cout_buffer);
+
+    CHECK(printed.str().empty());
+    CHECK(results.size() == paths.size());
+    for (size_t i = 0; i < 64; i++) {
+        if (i % 4 == 1) {
+            CHECK(!results[i].ok());
+            CHECK(results[i].error.find(paths[i].string()) != std::string::npos);
+            CHECK(results[i].error.find("Unknown character in json string: '?'") != std::string::npos);
+        } else if (i % 4 == 3) {
+            CHECK(!results[i].ok());
+            CHECK(results[i].error.find("nesting depth exceeds the maximum of 2") != std::string::npos);
+        } else {
+            CHECK(results[i].ok());
+            CHECK(results[i].error.empty());
+        }
+    }
+    CHECK(!results.back().ok());
+    CHECK(!results.back().error.empty());
+
+    // Errors outside of a batch are still printed
+    printed.str("");
+    std::cout.rdbuf(printed.rdbuf());
+    CHECK(!JsonParser::parse_buffer("{\"bad\": ?}").has_value());
+    std::cout.rdbuf(cout_buffer);
+    CHECK(printed.str().find("Unknown character") != std::string::npos);
+
+    std::filesystem::remove_all(directory);
+    return check_result("batch_test");
+}
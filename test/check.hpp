@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+/// @var `check_failures`
+/// @brief The number of checks which failed so far
+inline int check_failures = 0;
+
+/// @function `check`
+/// @brief Reports a failed check, use it through the `CHECK` macro
+inline void check(const bool condition, const char *expression, const char *file, const int line) {
+    if (!condition) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        check_failures++;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+/// @function `check_result`
+/// @brief Prints the summary of a test binary and returns its exit code
+inline int check_result(const char *test_name) {
+    if (check_failures != 0) {
+        std::fprintf(stderr, "%s: %d checks failed\n", test_name, check_failures);
+        return 1;
+    }
+    std::printf("%s: passed\n", test_name);
+    return 0;
+}
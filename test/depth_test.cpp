@@ -0,0 +1,69 @@
+#include "check.hpp"
+
+#include <json/lexer.hpp>
+#include <json/parser.hpp>
+
+#include <string>
+
+/// @struct `EventCount`
+/// @brief An event handler which only counts the events
+struct EventCount {
+    size_t events = 0;
+
+    bool on_object_begin() {
+        events++;
+        return true;
+    }
+    bool on_object_end() {
+        events++;
+        return true;
+    }
+    bool on_key(std::string_view) {
+        events++;
+        return true;
+    }
+    bool on_string(std::string_view) {
+        events++;
+        return true;
+    }
+    bool on_number(const JsonNumberValue &) {
+        events++;
+        return true;
+    }
+};
+
+/// @function `accepts`
+/// @brief Returns whether `parse`, `parse_buffer` and `parse_events` all accept the given json string, checks that they agree
+static bool accepts(const std::string &json, const size_t max_depth) {
+    JsonParseOptions options;
+    options.max_depth = max_depth;
+    const bool parsed = JsonParser::parse(JsonLexer::scan_buffer(json), options).has_value();
+    const bool parsed_buffer = JsonParser::parse_buffer(json, options).has_value();
+    EventCount handler;
+    const bool parsed_events = JsonParser::parse_events(json, handler, options);
+    CHECK(parsed == parsed_buffer);
+    CHECK(parsed == parsed_events);
+    return parsed && parsed_buffer && parsed_events;
+}
+
+/// All parsers count the root group as the first level of nesting and enforce the same limit
+int main() {
+    CHECK(!accepts("{}", 0));
+    CHECK(!accepts("{\"a\": 1}", 0));
+    CHECK(accepts("", 0));
+    CHECK(accepts("{\"a\": 1}", 1));
+    CHECK(!accepts("{\"a\": {\"b\": 1}}", 1));
+    CHECK(accepts("{\"a\": {\"b\": 1}}", 2));
+    CHECK(!accepts("{\"a\": {\"b\": {\"c\": 1}}}", 2));
+    CHECK(accepts("{\"a\": {}, \"b\": {}, \"c\": {\"d\": 1}}", 2));
+
+    std::string deep;
+    for (size_t i = 0; i < 1024; i++) {
+        deep += "{\"g\": ";
+    }
+    deep += "1";
+    deep.append(1024, '}');
+    CHECK(accepts(deep, 1024));
+    CHECK(!accepts(deep, 1023));
+    return check_result("depth_test");
+}
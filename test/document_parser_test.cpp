@@ -0,0 +1,53 @@
+#include "../bench/counting_new.hpp"
+#include "check.hpp"
+
+#include <json/document_parser.hpp>
+
+#include <string>
+#include <vector>
+
+/// @function `make_message`
+/// @brief Returns a small message like a daemon would receive it, the messages differ in their content but not in their shape
+static std::string make_message(const size_t id) {
+    const std::string number = std::to_string(id);
+    return "{\"id\": " + number + ", \"method\": \"update-" + number + "\", \"params\": {\"path\": \"/srv/data/" + number +
+        "\", \"size\": " + std::to_string(id * 31 % 4096) + ", \"flags\": {\"sync\": 1, \"mode\": \"rw\"}}}";
+}
+
+/// Steady-state parsing of similar documents with a reused JsonDocumentParser must not allocate
+int main() {
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 64; i++) {
+        messages.emplace_back(make_message(i));
+    }
+    JsonDocumentParser parser;
+
+    // The first round grows the retained buffers to their steady-state capacity, which also shows the counter is in place
+    const size_t allocations_warmup = allocation_count;
+    for (const std::string &message : messages) {
+        CHECK(parser.parse(message).has_value());
+    }
+    CHECK(allocation_count > allocations_warmup);
+
+    const size_t allocations_before = allocation_count;
+    size_t parsed = 0;
+    for (size_t round = 0; round < 1000; round++) {
+        const std::optional<JsonObject *> root = parser.parse(messages[round % messages.size()]);
+        if (root.has_value() && root.value()->as<JsonGroup>()->fields.size() == 3) {
+            parsed++;
+        }
+    }
+    const size_t allocations = allocation_count - allocations_before;
+    std::printf("%zu allocations over 1000 parses\n", allocations);
+    CHECK(parsed == 1000);
+    CHECK(allocations == 0);
+
+    // The parsed tree is correct, not just allocation-free
+    const std::optional<JsonObject *> root = parser.parse(messages[7]);
+    CHECK(root.has_value());
+    const JsonGroup *params = root.value()->as<JsonGroup>()->at("params").as<JsonGroup>();
+    CHECK(params != nullptr);
+    CHECK(params->at("path").as<JsonString>()->value == "/srv/data/7");
+    CHECK(params->at("size").as<JsonNumber>()->number == JsonNumberValue(7 * 31));
+    return check_result("document_parser_test");
+}
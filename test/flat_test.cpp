@@ -0,0 +1,40 @@
+#include "../bench/bench.hpp"
+#include "check.hpp"
+
+#include <json/flat.hpp>
+
+#include <memory>
+#include <string>
+
+int main() {
+    // A root which is no group becomes the only child of the `__ROOT__` group
+    const JsonNumber number("x", JsonNumberValue(5));
+    const JsonFlatDocument wrapped = JsonFlatDocument::from_tree(&number);
+    CHECK(wrapped.size() == 2);
+    CHECK(wrapped.child_count(0) == 1);
+    CHECK(wrapped.first_child(0) == 1);
+    CHECK(wrapped.number_value(1) == JsonNumberValue(5));
+    CHECK(JsonParser::to_string(wrapped.to_tree().get(), JsonFormat::COMPACT) == "{\"x\":5}");
+
+    // Conversions in both directions round-trip a regular document
+    const std::string json = "{\"name\": \"pkg\", \"deps\": {\"a\": {\"version\": 1.5}, \"b\": {}}, \"size\": 12}";
+    const std::optional<JsonFlatDocument> flat = JsonFlatDocument::parse(json);
+    CHECK(flat.has_value());
+    const std::unique_ptr<JsonObject> tree = flat->to_tree();
+    const std::string expected = "{\"name\":\"pkg\",\"deps\":{\"a\":{\"version\":1.5},\"b\":{}},\"size\":12}";
+    CHECK(JsonParser::to_string(tree.get(), JsonFormat::COMPACT) == expected);
+    CHECK(JsonParser::to_string(JsonFlatDocument::from_tree(tree.get()).to_tree().get(), JsonFormat::COMPACT) == expected);
+
+    // Documents the parser accepts with a raised depth limit convert without running out of stack
+    JsonParseOptions options;
+    options.max_depth = 300000;
+    const std::string deep_json = make_deep_document(200000);
+    const std::optional<JsonFlatDocument> deep = JsonFlatDocument::parse(deep_json, nullptr, options);
+    CHECK(deep.has_value());
+    const std::unique_ptr<JsonObject> deep_tree = deep->to_tree();
+    const JsonFlatDocument deep_again = JsonFlatDocument::from_tree(deep_tree.get());
+    CHECK(deep_again.size() == deep->size());
+    CHECK(JsonParser::to_string(deep_again.to_tree().get(), JsonFormat::COMPACT) ==
+        JsonParser::to_string(deep_tree.get(), JsonFormat::COMPACT));
+    return check_result("flat_test");
+}
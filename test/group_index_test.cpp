@@ -0,0 +1,76 @@
+#include "check.hpp"
+
+#include <json/parser.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// The lookup index of large groups has to follow every change of the field list, also those which keep the number of fields
+int main() {
+    JsonGroup group("group");
+    for (int i = 0; i < 20; i++) {
+        group.add_field(std::make_unique<JsonNumber>("field" + std::to_string(i), JsonNumberValue(i)));
+    }
+    CHECK(group.find("field3") != nullptr);
+    CHECK(group.find("field19") != nullptr);
+
+    // Removing one field and appending another keeps the size, the index still has to be rebuilt
+    group.fields.erase(group.fields.begin() + 3);
+    group.fields.push_back(std::make_unique<JsonString>("new", "value"));
+    CHECK(group.fields.size() == 20);
+    CHECK(group.find("field3") == nullptr);
+    CHECK(group.find("new") != nullptr);
+    CHECK(group.find("field19") == group.fields[18].get());
+
+    group.fields.pop_back();
+    group.fields.insert(group.fields.begin(), std::make_unique<JsonString>("first", "value"));
+    CHECK(group.find("new") == nullptr);
+    CHECK(group.find("first") == group.fields[0].get());
+    CHECK(group.find("field4") == group.fields[4].get());
+
+    // Renaming in place is not seen by the field list, the index is dropped by hand
+    group.fields[1]->name = "renamed";
+    group.invalidate_index();
+    CHECK(group.find("field0") == nullptr);
+    CHECK(group.find("renamed") == group.fields[1].get());
+
+    group.fields.clear();
+    CHECK(group.find("renamed") == nullptr);
+
+    // Const lookups never build the index, a changed group is searched linearly until the index is rebuilt
+    for (int i = 0; i < 20; i++) {
+        group.fields.push_back(std::make_unique<JsonNumber>("field" + std::to_string(i), JsonNumberValue(i)));
+    }
+    const JsonGroup &shared = group;
+    CHECK(shared.find("field7") == group.fields[7].get());
+    group.build_index();
+    CHECK(shared.find("field7") == group.fields[7].get());
+    CHECK(shared.find("missing") == nullptr);
+
+    // The parsers index every group they finish, so a parsed tree can be read from many threads at once
+    std::string json = "{";
+    for (int i = 0; i < 100; i++) {
+        json += (i == 0 ? "\"key" : ", \"key") + std::to_string(i) + "\": {\"value\": " + std::to_string(i) + "}";
+    }
+    json += "}";
+    const std::optional<std::unique_ptr<JsonObject>> parsed = JsonParser::parse_buffer(json);
+    CHECK(parsed.has_value());
+    const JsonGroup &root = *parsed.value()->as<JsonGroup>();
+    std::atomic<size_t> found = 0;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&] {
+            for (int i = 0; i < 100; i++) {
+                found += root.find("key" + std::to_string(i)) != nullptr ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    CHECK(found == 400);
+    return check_result("group_index_test");
+}
@@ -0,0 +1,80 @@
+#include "check.hpp"
+
+#include <json/integer.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// @function `parsed`
+/// @brief Parses the given digits into a `uint64_t`, `std::nullopt` if they are invalid or overflow
+static std::optional<uint64_t> parsed(const std::string &digits) {
+    uint64_t value;
+    if (!JsonInteger::parse(digits, value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/// @function `formatted`
+/// @brief Returns the text `format` writes for the given number
+template <typename T> static std::string formatted(const T value) {
+    char buffer[JsonInteger::MAX_FORMATTED_LENGTH];
+    return std::string(buffer, JsonInteger::format(value, buffer));
+}
+
+/// The integer kernels convert exactly, report overflow and invalid digits, and agree with `std::to_chars`
+int main() {
+    // Overflow is only detected at the 20th digit
+    CHECK(parsed("18446744073709551615") == UINT64_MAX);
+    CHECK(!parsed("18446744073709551616").has_value());
+    CHECK(!parsed("99999999999999999999").has_value());
+    CHECK(!parsed("100000000000000000000").has_value());
+    CHECK(parsed("9999999999999999999") == 9999999999999999999ULL);
+    CHECK(parsed("10000000000000000000") == 10000000000000000000ULL);
+
+    // Leading zeros do not count towards the length limit
+    CHECK(parsed("0") == 0U);
+    CHECK(parsed("00000000000000000000000000000000") == 0U);
+    CHECK(parsed("000000000000000000000018446744073709551615") == UINT64_MAX);
+    CHECK(!parsed("000000000000000000000018446744073709551616").has_value());
+    CHECK(parsed("0000000012345678") == 12345678U);
+    CHECK(!parsed("").has_value());
+
+    // A stray byte anywhere inside an eight digit block or the scalar tail is rejected
+    for (size_t i = 0; i < 19; i++) {
+        for (const char stray : {'/', ':', 'a', ' ', '\0', '\x80'}) {
+            std::string digits = "1234567890123456789";
+            digits[i] = stray;
+            CHECK(!parsed(digits).has_value());
+        }
+    }
+    for (const char stray : {'/', ':', 'e', '.'}) {
+        CHECK(!parsed(std::string("1844674407370955161") + stray).has_value());
+    }
+
+    // Narrowing to int
+    int value = 0;
+    CHECK(JsonInteger::parse("2147483647", value) && value == 2147483647);
+    CHECK(!JsonInteger::parse("2147483648", value));
+
+    // Every digit count formats like std::to_chars, including the extremes
+    CHECK(formatted(INT64_MIN) == "-9223372036854775808");
+    CHECK(formatted(INT64_MAX) == "9223372036854775807");
+    CHECK(formatted(UINT64_MAX) == "18446744073709551615");
+    CHECK(formatted(0) == "0");
+    CHECK(formatted(-7) == "-7");
+    CHECK(formatted(INT32_MIN) == "-2147483648");
+    uint64_t power = 1;
+    for (int digits = 1; digits <= 20; digits++) {
+        for (const uint64_t number : {power, power - 1, power + 9, power * 7 / 3}) {
+            char expected[JsonInteger::MAX_FORMATTED_LENGTH];
+            char *end = std::to_chars(expected, expected + sizeof(expected), number).ptr;
+            CHECK(formatted(number) == std::string(expected, end));
+            CHECK(parsed(formatted(number)) == number);
+        }
+        power *= digits < 20 ? 10 : 1;
+    }
+    return check_result("integer_test");
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <json/error.hpp>
+#include <json/lexer.hpp>
+
+#include <string>
+#include <vector>
+
+/// @struct `LexResult`
+/// @brief Everything a scan produces, the tokens as well as the error it reported
+struct LexResult {
+    bool success;
+    std::vector<JsonToken> tokens;
+    std::string error;
+
+    bool operator==(const LexResult &other) const {
+        if (success != other.success || error != other.error || tokens.size() != other.tokens.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (tokens[i].type != other.tokens[i].type || tokens[i].offset != other.tokens[i].offset ||
+                tokens[i].length != other.tokens[i].length) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/// @function `lex`
+/// @brief Scans the given input with the given scan function, capturing its error
+template <typename Scan> LexResult lex(Scan scan, const std::string &input) {
+    JsonErrorCapture capture;
+    LexResult result;
+    result.success = scan(input, result.tokens);
+    result.error = capture.message();
+    return result;
+}
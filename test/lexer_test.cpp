@@ -0,0 +1,80 @@
+#include "check.hpp"
+#include "lex_result.hpp"
+
+#include <json/error.hpp>
+#include <json/lexer.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/// @function `same_on_all_paths`
+/// @brief Returns whether every vectorized scan of the given input produces exactly the tokens and error of `scan_scalar`
+static bool same_on_all_paths(const std::string &input) {
+    const LexResult scalar = lex(JsonLexer::scan_scalar, input);
+    bool same = true;
+#if JSON_MINI_X86_SIMD
+    same &= lex(JsonLexer::scan_blocks<JsonSimd::classify_sse2>, input) == scalar;
+    if (JsonSimd::has_avx2()) {
+        same &= lex(JsonLexer::scan_blocks<JsonSimd::classify_avx2>, input) == scalar;
+    }
+#endif
+    if (!same) {
+        std::fprintf(stderr, "paths differ for input: %s\n", input.c_str());
+    }
+    return same;
+}
+
+/// The vectorized block scan produces the same token stream and the same errors as the scalar scan, no matter where a token
+/// crosses a block boundary
+int main() {
+    // Every token shape is shifted across the first and second 64 byte block boundary
+    const std::vector<std::string> shapes = {
+        "{\"key\": \"a string value which is long enough to span a whole block of sixty-four bytes on its own\"}",
+        "{\"a\": 12345.678e-9, \"b\": -0.5, \"c\": 9223372036854775808}",
+        "{\"a\": 1.2.3}",
+        "{\"a\": 01}",
+        "{\"a\": 1e}",
+        "{\"a\": --1, \"b\": 2}",
+        "{\"a\": \"unterminated string",
+        "{\"a\": 123",
+        "{\"a\": 123}",
+        "{\"a\": 1}x",
+        "{\"a\": @}",
+        "{\"a\": \"{}:,\", \"b\": \"1e5\"}",
+        "{\"\":\"\"}",
+        "{\"long\": \"" + std::string(300, 'x') + "\", \"after\": 12, \"b\": \"" + std::string(64, '}') + "\"}",
+        "{\"long\": \"" + std::string(300, ',') + "\"1}",
+        "{\"open\": \"" + std::string(300, 'x'),
+    };
+    for (const std::string &shape : shapes) {
+        for (size_t shift = 0; shift <= 140; shift++) {
+            CHECK(same_on_all_paths(std::string(shift, ' ') + shape));
+            CHECK(same_on_all_paths(std::string(shift, '\n') + shape + std::string(shift % 7, '\t')));
+        }
+    }
+    CHECK(!lex(JsonLexer::scan_scalar, std::string(60, ' ') + "{\"a\": \"unterminated").success);
+    const LexResult number_at_end = lex(JsonLexer::scan_scalar, std::string(62, ' ') + "{\"a\": 123");
+    CHECK(number_at_end.error == "Error: Json file ended with a number, not with a '}'");
+
+    // Random inputs built from token-sized pieces, so most of them lex far enough to cross several blocks
+    const std::vector<std::string> pieces = {"{", "}", ":", ",", " ", "\n\t", "        ", "\"key\"", "\"\"", "\"x{:}\"", "0", "-12",
+        "3.25", "1e-7", "6.02E+23", "18446744073709551616", "\"a long string body which spans a good part of a block\""};
+    const std::vector<std::string> rare_pieces = {"\"", "x", "01", "1."};
+    std::mt19937 random(4);
+    size_t successes = 0;
+    for (size_t i = 0; i < 20000; i++) {
+        std::string input;
+        for (size_t count = random() % 80; count > 0; count--) {
+            // Stray quotes and characters and invalid numbers end lexing for good, they are picked rarely
+            input += random() % 200 == 0 ? rare_pieces[random() % rare_pieces.size()] : pieces[random() % pieces.size()];
+        }
+        CHECK(same_on_all_paths(input));
+        std::vector<JsonToken> tokens;
+        JsonErrorCapture capture;
+        successes += JsonLexer::scan_scalar(input, tokens) ? 1 : 0;
+    }
+    // Both successful scans and errors deep into the input are covered
+    CHECK(successes > 1000 && successes < 19000);
+    return check_result("lexer_test");
+}
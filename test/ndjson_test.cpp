@@ -0,0 +1,84 @@
+#include "check.hpp"
+
+#include <json/error.hpp>
+#include <json/ndjson.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+/// @function `field`
+/// @brief Returns the number of the given field of a record, `-1` if there is no such number field
+static int64_t field(const std::optional<JsonObject *> &record, const std::string_view key) {
+    const JsonGroup *group = record.has_value() ? record.value()->as<JsonGroup>() : nullptr;
+    const JsonObject *value = group != nullptr ? group->find(key) : nullptr;
+    if (value == nullptr || value->as<JsonNumber>() == nullptr) {
+        return -1;
+    }
+    return value->as<JsonNumber>()->number.int64_value;
+}
+
+/// Records are read one per line from buffers and streams, blank and malformed lines are skipped
+int main() {
+    // CRLF line ends, blank and whitespace-only lines and a missing final newline
+    {
+        const std::string input = "{\"id\": 1}\r\n\r\n   \t\r\n{\"id\": 2}\r\n\n{\"id\": 3}";
+        JsonLinesReader reader = JsonLinesReader::from_buffer(input);
+        std::optional<JsonObject *> record;
+        CHECK(reader.next(record) && field(record, "id") == 1 && reader.line() == 1);
+        CHECK(reader.next(record) && field(record, "id") == 2 && reader.line() == 4);
+        CHECK(reader.next(record) && field(record, "id") == 3 && reader.line() == 6);
+        CHECK(reader.next(record) && !record.has_value());
+        CHECK(reader.next(record) && !record.has_value());
+    }
+
+    // A malformed line fails on its own line number and is skipped
+    {
+        const std::string input = "{\"id\": 1}\n{\"id\": }\n{\"id\": 3}\n";
+        JsonLinesReader reader = JsonLinesReader::from_buffer(input);
+        std::optional<JsonObject *> record;
+        CHECK(reader.next(record) && field(record, "id") == 1);
+        JsonErrorCapture capture;
+        CHECK(!reader.next(record) && !record.has_value());
+        CHECK(reader.line() == 2);
+        CHECK(!capture.message().empty());
+        CHECK(reader.next(record) && field(record, "id") == 3 && reader.line() == 3);
+        CHECK(reader.next(record) && !record.has_value());
+    }
+
+    // A record longer than one read chunk arrives through a pipe in pieces
+    {
+        std::string long_record = "{\"id\": 2, \"blob\": \"";
+        long_record.append(200000, 'x');
+        long_record += "\"}";
+        const std::string input = "{\"id\": 1}\n" + long_record + "\n\n{\"id\": 3}";
+        int pipe_fds[2];
+        CHECK(pipe(pipe_fds) == 0);
+        std::thread writer([&] {
+            size_t written = 0;
+            while (written < input.length()) {
+                const ssize_t result = write(pipe_fds[1], input.data() + written, std::min<size_t>(input.length() - written, 4096));
+                if (result <= 0) {
+                    break;
+                }
+                written += static_cast<size_t>(result);
+            }
+            close(pipe_fds[1]);
+        });
+        JsonLinesReader reader = JsonLinesReader::from_fd(pipe_fds[0]);
+        std::optional<JsonObject *> record;
+        CHECK(reader.next(record) && field(record, "id") == 1);
+        CHECK(reader.next(record) && field(record, "id") == 2 && reader.line() == 2);
+        const JsonObject *blob = record.has_value() ? record.value()->as<JsonGroup>()->find("blob") : nullptr;
+        CHECK(blob != nullptr && blob->as<JsonString>()->value.length() == 200000);
+        CHECK(reader.next(record) && field(record, "id") == 3 && reader.line() == 4);
+        CHECK(reader.next(record) && !record.has_value());
+        writer.join();
+        close(pipe_fds[0]);
+    }
+    return check_result("ndjson_test");
+}
@@ -0,0 +1,101 @@
+#include "check.hpp"
+
+#include <json/lexer.hpp>
+#include <json/number.hpp>
+#include <json/parser.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <string>
+
+/// @function `parsed`
+/// @brief Converts the given number text, `std::nullopt` if the conversion fails
+static std::optional<JsonNumberValue> parsed(const std::string_view text) {
+    JsonNumberValue number;
+    if (!JsonNumberValue::parse(text, number)) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+/// @function `formatted`
+/// @brief Returns the text `format` writes for the given number
+static std::string formatted(const JsonNumberValue &number) {
+    char buffer[JsonNumberValue::MAX_FORMATTED_LENGTH];
+    return std::string(buffer, number.format(buffer));
+}
+
+/// @function `is_double`
+/// @brief Returns whether the given number is stored as a double with exactly the given bits
+static bool is_double(const std::optional<JsonNumberValue> &number, const double expected) {
+    return number.has_value() && number->type == JsonNumberType::DOUBLE &&
+        std::memcmp(&number->double_value, &expected, sizeof(double)) == 0;
+}
+
+/// Numbers follow the json grammar, are stored in the narrowest exact type and are written in their shortest round-trip form
+int main() {
+    // Grammar, integer parts have no leading zeros
+    for (const char *valid : {"0", "-0", "7", "-12", "0.5", "-0.0", "1e5", "1E+5", "2.5e-3", "10", "100.001"}) {
+        CHECK(JsonLexer::is_valid_number(valid));
+    }
+    for (const char *invalid : {"", "-", "01", "-01", "00", "+1", ".5", "1.", "1.e5", "1e", "1e+", "--1", "1-", "0x10"}) {
+        CHECK(!JsonLexer::is_valid_number(invalid));
+    }
+    CHECK(!JsonParser::parse_buffer("{\"a\": 01}").has_value());
+    CHECK(JsonParser::parse_buffer("{\"a\": -0.5e-2}").has_value());
+
+    // Integers are stored as INT64 whenever they fit, UINT64 above it and as doubles beyond 2^64 - 1
+    CHECK(parsed("-0") == JsonNumberValue(0));
+    CHECK(parsed("9223372036854775807") == JsonNumberValue(INT64_MAX));
+    CHECK(parsed("9223372036854775808")->type == JsonNumberType::UINT64);
+    CHECK(parsed("-9223372036854775808") == JsonNumberValue(INT64_MIN));
+    CHECK(is_double(parsed("-9223372036854775809"), -9223372036854775808.0));
+    CHECK(parsed("18446744073709551615") == JsonNumberValue(UINT64_MAX));
+    CHECK(is_double(parsed("18446744073709551616"), 18446744073709551616.0));
+    CHECK(JsonNumberValue(uint64_t(5)).type == JsonNumberType::INT64);
+
+    // A minus sign on a zero double is kept, also when a tiny value underflows to zero
+    CHECK(is_double(parsed("-0.0"), -0.0));
+    CHECK(is_double(parsed("1e-400"), 0.0));
+    CHECK(is_double(parsed("-1e-400"), -0.0));
+    CHECK(is_double(parsed("0.000000001e-330"), 0.0));
+    CHECK(is_double(parsed("4.9406564584124654e-324"), 5e-324));
+
+    // Values beyond the range of a double are rejected, the largest double is not
+    CHECK(!parsed("1e309").has_value());
+    CHECK(!parsed("-1e309").has_value());
+    CHECK(!parsed("1000e306").has_value());
+    CHECK(is_double(parsed("1.7976931348623157e308"), 1.7976931348623157e308));
+    CHECK(is_double(parsed("0.0001e312"), 1e308));
+    CHECK(!JsonParser::parse_buffer("{\"a\": 1e400}").has_value());
+
+    // Doubles are written in their shortest form, always with a fraction or an exponent
+    CHECK(formatted(0.1) == "0.1");
+    CHECK(formatted(1.0) == "1.0");
+    CHECK(formatted(-0.0) == "-0.0");
+    CHECK(formatted(1e21) == "1e+21");
+    CHECK(formatted(5e-324) == "5e-324");
+    CHECK(formatted(INT64_MIN) == "-9223372036854775808");
+    CHECK(formatted(UINT64_MAX) == "18446744073709551615");
+    CHECK(formatted(-1.7976931348623157e308).length() <= JsonNumberValue::MAX_FORMATTED_LENGTH);
+
+    // Random finite bit patterns read back bit-exactly as doubles
+    std::mt19937_64 random(25);
+    size_t finite = 0;
+    size_t round_trips = 0;
+    for (size_t i = 0; i < 100000; i++) {
+        const uint64_t bits = random();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        finite++;
+        round_trips += is_double(parsed(formatted(value)), value) ? 1 : 0;
+    }
+    CHECK(finite > 90000);
+    CHECK(round_trips == finite);
+    return check_result("number_test");
+}
@@ -0,0 +1,52 @@
+#include "check.hpp"
+
+#include <json/error.hpp>
+#include <json/ondemand.hpp>
+
+#include <optional>
+#include <string_view>
+
+/// The cursor finds fields by skipping everything before them, nested groups included, and only decodes what it is asked for
+int main() {
+    const std::string_view json = "{\"skipped\": {\"text\": \"a } and a { inside\", \"deeper\": {\"x\": 1}}, \"size\": -2.5e3, "
+                                  "\"name\": \"json-mini\", \"group\": {\"a\": \"}\", \"b\": 2}}";
+    const std::optional<JsonCursor> root = JsonCursor::open(json);
+    CHECK(root.has_value() && root->is_group());
+
+    // The `}` inside the string of the skipped group does not end it early
+    const std::optional<JsonCursor> size = root->find_field("size");
+    CHECK(size.has_value() && size->type() == JsonTokenType::TOK_NUMBER);
+    CHECK(size->get_number() == JsonNumberValue(-2500.0));
+    CHECK(root->find_field("name")->get_string() == "json-mini");
+
+    // Fields of a nested group are found through its cursor only
+    const std::optional<JsonCursor> skipped = root->find_field("skipped");
+    CHECK(skipped.has_value() && skipped->is_group());
+    CHECK(skipped->find_field("text")->get_string() == "a } and a { inside");
+    CHECK(skipped->find_field("deeper")->find_field("x")->get_number() == JsonNumberValue(1));
+    CHECK(!root->find_field("x").has_value());
+
+    // A missing key
+    CHECK(!root->find_field("missing").has_value());
+    CHECK(!root->find_field("").has_value());
+
+    // The raw bytes of a group span up to its matching brace, values are raw tokens
+    CHECK(root->find_field("group")->raw() == "{\"a\": \"}\", \"b\": 2}");
+    CHECK(skipped->raw() == "{\"text\": \"a } and a { inside\", \"deeper\": {\"x\": 1}}");
+    CHECK(root->raw() == json);
+    CHECK(size->raw() == "-2.5e3");
+
+    // Values are only decoded as what they are
+    CHECK(!root->find_field("name")->get_number().has_value());
+    CHECK(!skipped->get_number().has_value());
+    CHECK(!size->get_string().has_value());
+    CHECK(!size->find_field("size").has_value());
+
+    // Malformed input is reported instead of being walked past
+    JsonErrorCapture capture;
+    CHECK(!JsonCursor::open("\"text\"").has_value());
+    CHECK(!JsonCursor::open("{\"a\" 1}")->find_field("a").has_value());
+    CHECK(!JsonCursor::open("{\"a\": {\"b\": 1}")->find_field("c").has_value());
+    CHECK(!capture.message().empty());
+    return check_result("ondemand_test");
+}
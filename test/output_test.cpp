@@ -0,0 +1,75 @@
+#include "check.hpp"
+
+#include <json/parser.hpp>
+
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/// A failed write to the file descriptor of an output is kept and reported, instead of being dropped
+int main() {
+    std::string json = "{";
+    for (size_t i = 0; i < 2000; i++) {
+        json += "\"field" + std::to_string(i) + "\": {\"value\": " + std::to_string(i) + "},";
+    }
+    json += "\"last\": \"value\"}";
+    const std::optional<std::unique_ptr<JsonObject>> root = JsonParser::parse_buffer(json);
+    CHECK(root.has_value());
+
+    // Writing into a pipe produces the same text as in-memory output
+    int pipe_fds[2];
+    CHECK(pipe(pipe_fds) == 0);
+    {
+        JsonOutputBuffer output(pipe_fds[1], 16);
+        JsonOutputBuffer compact;
+        CHECK(JsonParser::write(root.value()->as<JsonGroup>()->find("field7"), output, JsonFormat::COMPACT));
+        CHECK(JsonParser::write(root.value()->as<JsonGroup>()->find("field7"), compact, JsonFormat::COMPACT));
+        CHECK(output.flush());
+        CHECK(output.good());
+        char text[64] = {};
+        CHECK(read(pipe_fds[0], text, sizeof(text)) == static_cast<ssize_t>(compact.view().length()));
+        CHECK(compact.view() == text);
+    }
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+
+    // Every write to /dev/full fails, the failure stays visible until the end
+    const int full = open("/dev/full", O_WRONLY);
+    if (full >= 0) {
+        JsonOutputBuffer output(full, 1024);
+        CHECK(!JsonParser::write(root.value().get(), output));
+        CHECK(!output.good());
+        CHECK(output.view().length() < 1024);
+        output.append("more text");
+        CHECK(!output.flush());
+        CHECK(!output.good());
+        CHECK(output.view().empty());
+        close(full);
+    }
+
+    // Trees can not hold numbers json has no representation for, so everything written parses back
+    bool rejected = false;
+    try {
+        JsonNumber("x", std::numeric_limits<double>::quiet_NaN());
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    CHECK(rejected);
+    JsonGroup group("__ROOT__");
+    group.add_field(std::make_unique<JsonNumber>("x", 1e300 * 10));
+    group.add_field(std::make_unique<JsonNumber>("y", 1e20));
+    const std::string text = JsonParser::to_string(&group, JsonFormat::COMPACT);
+    CHECK(text == "{\"x\":1e+301,\"y\":1e+20}");
+    CHECK(JsonParser::parse_buffer(text).has_value());
+
+    // In-memory output never fails
+    JsonOutputBuffer memory;
+    CHECK(JsonParser::write(root.value().get(), memory));
+    CHECK(memory.flush());
+    CHECK(memory.good());
+    return check_result("output_test");
+}
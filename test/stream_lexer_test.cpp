@@ -0,0 +1,84 @@
+#include "check.hpp"
+#include "lex_result.hpp"
+
+#include <json/error.hpp>
+#include <json/lexer.hpp>
+#include <json/stream_lexer.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+/// @function `scan_chunked`
+/// @brief Feeds the input to the stream lexer in chunks of random sizes from 1 to `max_chunk` bytes, and checks that the content
+/// of every emitted token is the text at its offset
+static LexResult scan_chunked(JsonStreamLexer &lexer, const std::string &input, std::mt19937 &random, const size_t max_chunk) {
+    JsonErrorCapture capture;
+    LexResult result{true, {}, {}};
+    size_t pos = 0;
+    while (pos < input.length() && result.success) {
+        const size_t length = std::min<size_t>(1 + random() % max_chunk, input.length() - pos);
+        result.success = lexer.feed(std::string_view(input).substr(pos, length), [&](const JsonToken &token, std::string_view content) {
+            CHECK(content == std::string_view(input).substr(token.offset, token.length));
+            result.tokens.emplace_back(token);
+        });
+        pos += length;
+    }
+    // A failed feed has already reported its error, finish only resets the lexer then
+    result.success = lexer.finish() && result.success;
+    result.error = capture.message();
+    return result;
+}
+
+/// Feeding a document in chunks of any size produces the same tokens and errors as scanning it at once
+int main() {
+    // A string and a number are cut at every possible position by a two-chunk split
+    const std::string document = "{\"name\": \"a string which gets cut\", \"size\": -1234.5e+6, \"nested\": {\"n\": 7}}";
+    JsonStreamLexer lexer;
+    for (size_t split = 0; split <= document.length(); split++) {
+        std::vector<JsonToken> tokens;
+        CHECK(lexer.feed(std::string_view(document).substr(0, split), [&](const JsonToken &token, std::string_view) {
+            tokens.emplace_back(token);
+        }));
+        CHECK(lexer.feed(std::string_view(document).substr(split), [&](const JsonToken &token, std::string_view) {
+            tokens.emplace_back(token);
+        }));
+        CHECK(lexer.finish());
+        const LexResult chunked{true, tokens, ""};
+        CHECK(chunked == lex(JsonLexer::scan_scalar, document));
+    }
+
+    // An open string or number at the end of the stream is reported by finish, which also resets the lexer
+    std::mt19937 random(6);
+    for (const char *input : {"{\"a\": \"open", "{\"a\": 12", "{\"a\": 1.", "{\"a\": 01}", "{\"a\": 1}", "{\"a\": $}"}) {
+        for (const size_t max_chunk : {1, 2, 3, 64}) {
+            CHECK(scan_chunked(lexer, input, random, max_chunk) == lex(JsonLexer::scan_scalar, input));
+        }
+    }
+    {
+        JsonErrorCapture capture;
+        CHECK(lexer.feed("{\"a\": \"open", [](const JsonToken &, std::string_view) {}));
+        CHECK(!lexer.finish());
+        CHECK(capture.message() == "Error: Unterminated string value at the end of the json string");
+        CHECK(lexer.feed("{}", [](const JsonToken &, std::string_view) {}));
+        CHECK(lexer.finish());
+    }
+    {
+        JsonErrorCapture capture;
+        CHECK(lexer.feed("{\"a\": 12", [](const JsonToken &, std::string_view) {}));
+        CHECK(!lexer.finish());
+        CHECK(capture.message() == "Error: Json file ended with a number, not with a '}'");
+    }
+
+    // Random documents in random chunk sizes, down to single bytes
+    const std::vector<std::string> pieces = {"{", "}", ":", ",", " ", "\n", "\"key\"", "\"\"", "\"x{:}\"", "0", "-12", "3.25", "1e-7",
+        "6.02E+23", "\"a long string body which is cut by most chunk boundaries\""};
+    for (size_t i = 0; i < 5000; i++) {
+        std::string input;
+        for (size_t count = random() % 60; count > 0; count--) {
+            input += random() % 300 == 0 ? std::string("01") : pieces[random() % pieces.size()];
+        }
+        CHECK(scan_chunked(lexer, input, random, i % 4 == 0 ? 1 : 1 + i % 97) == lex(JsonLexer::scan_scalar, input));
+    }
+    return check_result("stream_lexer_test");
+}
@@ -15,7 +15,7 @@ int main(int argc, char *argv[]) {
     }
     std::filesystem::path file_path = cwd / file_str;
 
-    std::vector<JsonToken> tokens = JsonLexer::scan(file_path);
+    JsonTokenList tokens = JsonLexer::scan(file_path);
     JsonLexer::print_tokens(tokens);
     std::optional<std::unique_ptr<JsonObject>> object = JsonParser::parse(tokens);
     if (!object.has_value()) {
@@ -0,0 +1,42 @@
+#include "check.hpp"
+
+#include <json/lexer.hpp>
+#include <json/parser.hpp>
+#include <json/stream_lexer.hpp>
+
+#include <string>
+
+/// `parse` accepts token lists which were built without a brace table, or whose table no longer covers their tokens
+int main() {
+    const std::string json = "{\"a\": {\"b\": {\"c\": 1}, \"d\": \"}\"}, \"e\": {}, \"f\": 2}";
+    const std::optional<std::unique_ptr<JsonObject>> expected = JsonParser::parse(JsonLexer::scan_buffer(json));
+    CHECK(expected.has_value());
+    const std::string expected_text = JsonParser::to_string(expected.value().get(), JsonFormat::COMPACT);
+
+    // Tokens collected from the stream lexer, fed in small chunks
+    JsonTokenList streamed;
+    streamed.source = JsonSource::from_view(json);
+    JsonStreamLexer lexer;
+    for (size_t pos = 0; pos < json.length(); pos += 5) {
+        CHECK(lexer.feed(std::string_view(json).substr(pos, 5), [&](const JsonToken &token, std::string_view) {
+            streamed.tokens.emplace_back(token);
+        }));
+    }
+    CHECK(lexer.finish());
+    CHECK(!streamed.has_brace_index());
+    const std::optional<std::unique_ptr<JsonObject>> from_stream = JsonParser::parse(streamed);
+    CHECK(from_stream.has_value() && JsonParser::to_string(from_stream.value().get(), JsonFormat::COMPACT) == expected_text);
+    CHECK(!streamed.has_brace_index());
+
+    // A table which was built before more tokens were added is stale
+    JsonTokenList stale;
+    stale.source = JsonSource::from_view(json);
+    CHECK(JsonLexer::scan_scalar(json.substr(0, 6), stale.tokens));
+    CHECK(stale.index_braces());
+    stale.tokens.clear();
+    CHECK(JsonLexer::scan_scalar(json, stale.tokens));
+    CHECK(!stale.has_brace_index());
+    const std::optional<std::unique_ptr<JsonObject>> from_stale = JsonParser::parse(stale);
+    CHECK(from_stale.has_value() && JsonParser::to_string(from_stale.value().get(), JsonFormat::COMPACT) == expected_text);
+    return check_result("token_list_test");
+}
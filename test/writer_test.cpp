@@ -0,0 +1,64 @@
+#include "check.hpp"
+
+#include <json/parser.hpp>
+#include <json/writer.hpp>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/// @function `throws_invalid_argument`
+/// @brief Returns whether adding the given number to an open object throws `std::invalid_argument`
+static bool throws_invalid_argument(JsonWriter &writer, const double value) {
+    try {
+        writer.add_number("bad", value);
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+    return false;
+}
+
+/// The writer produces the same text as writing the equivalent tree, never writes numbers json can not represent and accepts the
+/// same nesting depth as the parser
+int main() {
+    JsonOutputBuffer output;
+    JsonWriter writer(output, JsonFormat::COMPACT);
+    writer.begin_object();
+    writer.add_number("a", 1);
+    CHECK(throws_invalid_argument(writer, std::numeric_limits<double>::quiet_NaN()));
+    CHECK(throws_invalid_argument(writer, std::numeric_limits<double>::infinity()));
+    CHECK(throws_invalid_argument(writer, -std::numeric_limits<double>::infinity()));
+    writer.add_number("b", 2.5);
+    writer.begin_object("c");
+    writer.add_string("d", "text");
+    writer.end_object();
+    writer.end_object();
+    CHECK(writer.is_complete());
+    CHECK(output.view() == "{\"a\":1,\"b\":2.5,\"c\":{\"d\":\"text\"}}");
+
+    const std::optional<std::unique_ptr<JsonObject>> root = JsonParser::parse_buffer(output.view());
+    CHECK(root.has_value());
+    CHECK(JsonParser::to_string(root.value().get(), JsonFormat::COMPACT) == output.view());
+
+    // The writer enforces the same depth limit as the parser, every document it writes can be parsed again
+    CHECK(JsonWriter::DEFAULT_MAX_DEPTH == JsonParseOptions().max_depth);
+    JsonOutputBuffer deep_output;
+    JsonWriter deep_writer(deep_output, JsonFormat::COMPACT);
+    deep_writer.begin_object();
+    for (size_t depth = 1; depth < JsonWriter::DEFAULT_MAX_DEPTH; depth++) {
+        deep_writer.begin_object("g");
+    }
+    bool too_deep = false;
+    try {
+        deep_writer.begin_object("g");
+    } catch (const std::length_error &) {
+        too_deep = true;
+    }
+    CHECK(too_deep);
+    for (size_t depth = 0; depth < JsonWriter::DEFAULT_MAX_DEPTH; depth++) {
+        deep_writer.end_object();
+    }
+    CHECK(deep_writer.is_complete());
+    CHECK(JsonParser::parse_buffer(deep_output.view()).has_value());
+    return check_result("writer_test");
+}